@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "GaugeCore.h"
+
+namespace ErfBench {
+    struct Fired {
+        RE::FormID id;
+        ERF_ReactionHandle reaction;
+    };
+
+    // Stands in for RE::Calendar and the real-time clock. Game hours advance at the timescale, which may change
+    // between steps just as fTimescale can in game.
+    class SimClock final : public Gauges::Clock {
+    public:
+        double rt = 0.0;
+        double hours = 0.0;
+        float ts = 20.0f;
+
+        double nowRt() const override { return rt; }
+        float nowH() const override { return static_cast<float>(hours); }
+        float timescale() const override { return ts; }
+
+        void step(double dt) noexcept {
+            rt += dt;
+            hours += dt * ts / 3600.0;
+        }
+        void set(double rtS, float h) noexcept {
+            rt = rtS;
+            hours = h;
+        }
+    };
+
+    // No player, nobody dies, no states: multipliers stay at 1.0.
+    class SimActors final : public Gauges::Actors {
+    public:
+        bool isPlayer(RE::FormID) const override { return false; }
+        bool isGone(RE::FormID) const override { return false; }
+        void gaugeMultipliers(RE::FormID, std::span<double>) const override {}
+    };
+
+    // Callbacks are counted, not run; there is no actor to hand them.
+    class SimTasks final : public Gauges::Tasks {
+    public:
+        std::uint64_t posted = 0;
+
+        void reaction(RE::FormID, ERF_ReactionCallback, void*) override { ++posted; }
+        void preEffect(RE::FormID, ERF_PreEffectDesc::Callback, ERF_ElementHandle, std::uint8_t, float,
+                       void*) override {
+            ++posted;
+        }
+    };
+
+    class SimEvents final : public Gauges::Events {
+    public:
+        std::uint64_t reactions = 0;
+        std::vector<Fired>* fired = nullptr;
+
+        void reaction(RE::FormID id, ERF_ReactionHandle rh, float, double, float) override {
+            ++reactions;
+            if (fired) fired->push_back(Fired{id, rh});
+        }
+    };
+
+    // Everything the gauge core needs, bound in one call. Must outlive every gauge call.
+    struct SimHost {
+        SimClock clock;
+        SimActors actors;
+        SimTasks tasks;
+        SimEvents events;
+        Gauges::Tuning tuning;
+
+        void bind() { Gauges::Bind(Gauges::Host{&clock, &actors, &tasks, &events, &tuning, nullptr}); }
+    };
+}
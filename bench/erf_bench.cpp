@@ -0,0 +1,612 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "GaugeArena.h"
+#include "SimHost.h"
+#include "erf_element.h"
+#include "erf_reaction.h"
+
+// Allocation counters for the measured window. Every global new goes through here.
+namespace {
+    std::atomic<std::uint64_t> g_allocs{0};
+    std::atomic<std::uint64_t> g_allocBytes{0};
+
+    void* countedAlloc(std::size_t n, std::size_t align) {
+        g_allocs.fetch_add(1, std::memory_order_relaxed);
+        g_allocBytes.fetch_add(n, std::memory_order_relaxed);
+        if (n == 0) n = 1;
+#if defined(_WIN32)
+        void* p = align > alignof(std::max_align_t) ? _aligned_malloc(n, align) : std::malloc(n);
+#else
+        void* p = align > alignof(std::max_align_t) ? std::aligned_alloc(align, (n + align - 1) & ~(align - 1))
+                                                    : std::malloc(n);
+#endif
+        if (!p) throw std::bad_alloc{};
+        return p;
+    }
+
+    void countedFree(void* p, std::size_t align) noexcept {
+#if defined(_WIN32)
+        if (align > alignof(std::max_align_t)) {
+            _aligned_free(p);
+            return;
+        }
+#endif
+        (void)align;
+        std::free(p);
+    }
+}
+
+void* operator new(std::size_t n) { return countedAlloc(n, alignof(std::max_align_t)); }
+void* operator new[](std::size_t n) { return countedAlloc(n, alignof(std::max_align_t)); }
+void* operator new(std::size_t n, std::align_val_t a) { return countedAlloc(n, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t n, std::align_val_t a) { return countedAlloc(n, static_cast<std::size_t>(a)); }
+void operator delete(void* p) noexcept { countedFree(p, alignof(std::max_align_t)); }
+void operator delete[](void* p) noexcept { countedFree(p, alignof(std::max_align_t)); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p, alignof(std::max_align_t)); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p, alignof(std::max_align_t)); }
+void operator delete(void* p, std::align_val_t a) noexcept { countedFree(p, static_cast<std::size_t>(a)); }
+void operator delete[](void* p, std::align_val_t a) noexcept { countedFree(p, static_cast<std::size_t>(a)); }
+void operator delete(void* p, std::size_t, std::align_val_t a) noexcept {
+    countedFree(p, static_cast<std::size_t>(a));
+}
+void operator delete[](void* p, std::size_t, std::align_val_t a) noexcept {
+    countedFree(p, static_cast<std::size_t>(a));
+}
+
+using namespace ErfBench;
+
+namespace {
+    struct Options {
+        int actors = 64;
+        int elements = 8;
+        int reactions = 24;
+        int fps = 60;
+        double seconds = 60.0;
+        int hitsPerFrame = 32;
+        double dotFrac = 0.8;
+        bool batch = true;
+        bool single = false;
+        int picks = 200000;
+        int entryRounds = 200;
+        int candidates = 200000;
+        int wideElements = 200;
+        std::uint32_t seed = 1;
+    };
+
+    bool parseArg(std::string_view arg, Options& o) {
+        const auto eq = arg.find('=');
+        if (!arg.starts_with("--") || eq == std::string_view::npos) return false;
+        const auto key = arg.substr(2, eq - 2);
+        const std::string val{arg.substr(eq + 1)};
+
+        if (key == "actors")
+            o.actors = std::stoi(val);
+        else if (key == "elements")
+            o.elements = std::stoi(val);
+        else if (key == "reactions")
+            o.reactions = std::stoi(val);
+        else if (key == "fps")
+            o.fps = std::stoi(val);
+        else if (key == "seconds")
+            o.seconds = std::stod(val);
+        else if (key == "hits")
+            o.hitsPerFrame = std::stoi(val);
+        else if (key == "dot")
+            o.dotFrac = std::stod(val);
+        else if (key == "batch")
+            o.batch = std::stoi(val) != 0;
+        else if (key == "single")
+            o.single = std::stoi(val) != 0;
+        else if (key == "picks")
+            o.picks = std::stoi(val);
+        else if (key == "entries")
+            o.entryRounds = std::stoi(val);
+        else if (key == "candidates")
+            o.candidates = std::stoi(val);
+        else if (key == "wide")
+            o.wideElements = std::stoi(val);
+        else if (key == "seed")
+            o.seed = static_cast<std::uint32_t>(std::stoul(val));
+        else
+            return false;
+        return true;
+    }
+
+    void registerContent(const Options& o, std::mt19937& rng) {
+        auto& ER = ElementRegistry::get();
+        for (int i = 0; i < o.elements; ++i) {
+            ERF_ElementDesc d{};
+            d.name = "Element" + std::to_string(i);
+            d.colorRGB = 0xFFFFFF;
+            d.keyword = nullptr;
+            ER.registerElement(d);
+        }
+        ER.freeze();
+
+        auto& RR = ReactionRegistry::get();
+        std::uniform_int_distribution<int> elemDist(1, o.elements);
+        std::uniform_int_distribution<int> sizeDist(2, std::min(3, std::max(2, o.elements)));
+        std::uniform_real_distribution<float> pctDist(0.05f, 0.25f);
+        std::uniform_real_distribution<float> lockDist(0.5f, 3.0f);
+        for (int r = 0; r < o.reactions; ++r) {
+            ERF_ReactionDesc d{};
+            d.name = "Reaction" + std::to_string(r);
+            const int k = sizeDist(rng);
+            while (static_cast<int>(d.elements.size()) < std::min(k, o.elements)) {
+                const auto h = static_cast<ERF_ElementHandle>(elemDist(rng));
+                if (std::ranges::find(d.elements, h) == d.elements.end()) d.elements.push_back(h);
+            }
+            d.minPctEach = pctDist(rng);
+            d.elementLockoutSeconds = lockDist(rng);
+            RR.registerReaction(d);
+        }
+        RR.freeze();
+    }
+
+    struct PickResult {
+        double nsPerCall = 0.0;
+        std::uint64_t hits = 0;
+        std::uint64_t checksum = 0;
+    };
+
+    // Times pickBestFast over a ring of pre-built gauge states, with the registry in whichever eval mode is set.
+    PickResult timePicks(int calls, const std::vector<std::uint8_t>& totals,
+                         const std::vector<ERF_ElementHandle>& present, const std::vector<std::uint32_t>& presentStart,
+                         std::size_t stride) {
+        const auto& RR = ReactionRegistry::get();
+        const std::size_t states = presentStart.size() - 1;
+        PickResult r;
+
+        using Clock = std::chrono::steady_clock;
+        const auto t0 = Clock::now();
+        for (int c = 0; c < calls; ++c) {
+            const std::size_t s = static_cast<std::size_t>(c) % states;
+            const std::span<const std::uint8_t> t(totals.data() + s * stride, stride);
+            const std::span<const ERF_ElementHandle> p(present.data() + presentStart[s],
+                                                       presentStart[s + 1] - presentStart[s]);
+            int sumAll = 0;
+            for (auto h : p) sumAll += t[h];
+            const auto best = RR.pickBestFast(t, p, sumAll, 1.0f / static_cast<float>(sumAll));
+            if (best) {
+                ++r.hits;
+                r.checksum = r.checksum * 31 + best->handle;
+            }
+        }
+        const double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        r.nsPerCall = calls > 0 ? s * 1e9 / calls : 0.0;
+        return r;
+    }
+
+    struct CandidateTimes {
+        double indexNs = 0.0;
+        double linearNs = 0.0;
+        double perQuery = 0.0;
+        bool dense = false;
+        bool same = true;
+    };
+
+    // Candidate enumeration only, no threshold checks: ERF_ReactionIndex against walking every reaction in priority
+    // order and testing its mask. Both must produce the same sequence for every present mask.
+    template <std::size_t Words>
+    CandidateTimes timeCandidates(int queries, int elements, int reactions, std::mt19937& rng) {
+        using Mask = ElementMask<Words>;
+        const int maxElem = std::min<int>(elements, static_cast<int>(Mask::kBits));
+        std::uniform_int_distribution<int> elemDist(1, maxElem);
+        std::uniform_int_distribution<int> sizeDist(1, std::min(4, maxElem));
+        std::uniform_int_distribution<int> presentDist(2, std::min(6, maxElem));
+
+        const auto randomMask = [&](int n) {
+            Mask m{};
+            for (int k = 0; k < n; ++k) m.set(static_cast<std::size_t>(elemDist(rng) - 1));
+            return m;
+        };
+
+        std::vector<Mask> masks(static_cast<std::size_t>(reactions) + 1);
+        for (std::size_t h = 1; h < masks.size(); ++h) masks[h] = randomMask(sizeDist(rng));
+        ERF_ReactionIndex<Words> ix;
+        ix.build(masks);
+
+        std::vector<ERF_ReactionHandle> order;
+        for (std::size_t h = 1; h < masks.size(); ++h) order.push_back(static_cast<ERF_ReactionHandle>(h));
+        std::ranges::stable_sort(order,
+                                 [&](ERF_ReactionHandle a, ERF_ReactionHandle b) { return masks[a] > masks[b]; });
+        std::vector<Mask> orderMask;
+        for (auto h : order) orderMask.push_back(masks[h]);
+
+        const auto linear = [&](const Mask& present, auto&& visit) {
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                if (orderMask[i].subsetOf(present) && visit(order[i])) return;
+            }
+        };
+
+        constexpr std::size_t kStates = 1024;
+        std::vector<Mask> present(kStates);
+        for (auto& m : present) m = randomMask(presentDist(rng));
+
+        CandidateTimes t;
+        t.dense = ix.denseBits != 0;
+        std::vector<ERF_ReactionHandle> a;
+        std::vector<ERF_ReactionHandle> b;
+        for (const auto& m : present) {
+            a.clear();
+            b.clear();
+            ix.forEachCandidate(m, [&](ERF_ReactionHandle h) { return a.push_back(h), false; });
+            linear(m, [&](ERF_ReactionHandle h) { return b.push_back(h), false; });
+            t.same = t.same && a == b;
+        }
+
+        // The visitor never stops the walk, so both sides enumerate every candidate.
+        using Clock = std::chrono::steady_clock;
+        std::uint64_t found = 0;
+        const auto visit = [&](ERF_ReactionHandle h) { return found += h, false; };
+        const auto t0 = Clock::now();
+        for (int q = 0; q < queries; ++q) ix.forEachCandidate(present[static_cast<std::size_t>(q) % kStates], visit);
+        const auto t1 = Clock::now();
+        const auto indexSum = std::exchange(found, 0);
+        for (int q = 0; q < queries; ++q) linear(present[static_cast<std::size_t>(q) % kStates], visit);
+        const auto t2 = Clock::now();
+
+        t.same = t.same && found == indexSum;
+        t.indexNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / std::max(1, queries);
+        t.linearNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / std::max(1, queries);
+        std::size_t listed = 0;
+        for (const auto& m : present) ix.forEachCandidate(m, [&](ERF_ReactionHandle) { return ++listed, false; });
+        t.perQuery = static_cast<double>(listed) / kStates;
+        return t;
+    }
+
+    // The per-actor layout the arena replaced: one heap vector per field, allocated when an actor is first hit and
+    // freed when it is evicted.
+    struct VectorEntry {
+        std::vector<std::uint8_t> v;
+        std::vector<float> lastHitH;
+        std::vector<float> lastEvalH;
+        std::vector<float> blockUntilH;
+        std::vector<double> blockUntilRtS;
+        std::vector<double> reactCdRtS;
+        std::vector<float> reactCdH;
+        std::vector<std::uint8_t> inReaction;
+        std::vector<std::uint8_t> preActive;
+        std::vector<float> preIntensity;
+        std::vector<double> preExpireRtS;
+        std::vector<float> preExpireH;
+        std::vector<double> effMult;
+        std::vector<ERF_ElementHandle> presentList;
+        std::vector<std::uint16_t> posInList;
+
+        VectorEntry(std::size_t nE, std::size_t nR, std::size_t nP)
+            : v(nE),
+              lastHitH(nE),
+              lastEvalH(nE),
+              blockUntilH(nE),
+              blockUntilRtS(nE),
+              reactCdRtS(nR),
+              reactCdH(nR),
+              inReaction(nR),
+              preActive(nP),
+              preIntensity(nP),
+              preExpireRtS(nP),
+              preExpireH(nP),
+              effMult(nE, 1.0),
+              posInList(nE, 0xFFFF) {
+            presentList.reserve(nE);
+        }
+    };
+
+    // The fields a decay pass touches, bound once per slot the way Gauges::Entry binds them.
+    struct ArenaEntry {
+        std::uint32_t slot;
+        std::span<std::uint8_t> v;
+        std::span<float> lastHitH;
+        std::span<float> lastEvalH;
+    };
+
+    constexpr std::size_t kTouchedPerEntry = 3;
+
+    // A decay-shaped pass: a few elements per actor, each read and written back.
+    template <class E>
+    std::uint64_t sweepEntries(std::vector<E>& entries, const std::vector<std::uint16_t>& touched, float nowH) {
+        std::uint64_t sum = 0;
+        for (std::size_t n = 0; n < entries.size(); ++n) {
+            auto& e = entries[n];
+            for (std::size_t k = 0; k < kTouchedPerEntry; ++k) {
+                const std::size_t i = touched[n * kTouchedPerEntry + k];
+                auto& val = e.v[i];
+                if (val) {
+                    --val;
+                    e.lastEvalH[i] = nowH;
+                } else {
+                    val = 60;
+                    e.lastHitH[i] = nowH;
+                }
+                sum += val;
+            }
+        }
+        return sum;
+    }
+
+    struct EntryTimes {
+        double churnNs = 0.0;
+        double sweepNs = 0.0;
+        double allocs = 0.0;
+    };
+
+    // Per entry: acquire and release (churn) and one decay-shaped pass (sweep), averaged over every round.
+    template <class Acquire, class Release, class E>
+    EntryTimes timeEntries(int rounds, std::vector<E>& entries, std::size_t actors,
+                           const std::vector<std::uint16_t>& touched, Acquire&& acquire, Release&& release,
+                           std::uint64_t& sink) {
+        using Clock = std::chrono::steady_clock;
+        Clock::duration churn{};
+        Clock::duration sweep{};
+        const auto allocs0 = g_allocs.load();
+
+        for (int r = 0; r < rounds; ++r) {
+            const auto t0 = Clock::now();
+            for (std::size_t n = 0; n < actors; ++n) acquire(entries);
+            const auto t1 = Clock::now();
+            sink += sweepEntries(entries, touched, static_cast<float>(r));
+            const auto t2 = Clock::now();
+            release(entries);
+            const auto t3 = Clock::now();
+            churn += (t1 - t0) + (t3 - t2);
+            sweep += t2 - t1;
+        }
+
+        const double perEntry = static_cast<double>(rounds) * static_cast<double>(actors);
+        EntryTimes t;
+        t.churnNs = std::chrono::duration<double, std::nano>(churn).count() / perEntry;
+        t.sweepNs = std::chrono::duration<double, std::nano>(sweep).count() / perEntry;
+        t.allocs = static_cast<double>(g_allocs.load() - allocs0) / perEntry;
+        return t;
+    }
+
+    std::uint64_t percentile(std::vector<std::uint32_t>& ns, double p) {
+        if (ns.empty()) return 0;
+        const auto k = static_cast<std::size_t>(p * static_cast<double>(ns.size() - 1));
+        std::ranges::nth_element(ns, ns.begin() + static_cast<std::ptrdiff_t>(k));
+        return ns[k];
+    }
+}
+
+int main(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        if (!parseArg(argv[i], o)) {
+            std::fprintf(stderr,
+                         "usage: erf_bench [--actors=N] [--elements=M] [--reactions=R] [--fps=F] [--seconds=S]\n"
+                         "                 [--hits=PER_FRAME] [--dot=FRACTION] [--batch=0|1] [--single=0|1]\n"
+                         "                 [--picks=N] [--entries=ROUNDS] [--candidates=N] [--wide=ELEMENTS]\n"
+                         "                 [--seed=N]\n");
+            return 2;
+        }
+    }
+    o.actors = std::max(1, o.actors);
+    o.elements = std::clamp(o.elements, 1, 4096);
+    o.fps = std::max(1, o.fps);
+
+    std::mt19937 rng{o.seed};
+    registerContent(o, rng);
+
+    SimHost host;
+    host.tuning.isSingle = o.single;
+    host.bind();
+
+    const auto frames = static_cast<std::uint64_t>(o.seconds * o.fps);
+    const double dt = 1.0 / o.fps;
+
+    // Pre-generated so the measured loop only pays for gauge work.
+    std::uniform_int_distribution<int> actorDist(0, o.actors - 1);
+    std::uniform_int_distribution<int> elemDist(1, o.elements);
+    std::uniform_int_distribution<int> dotDelta(1, 3);
+    std::uniform_int_distribution<int> instDelta(10, 35);
+    std::bernoulli_distribution isDot(std::clamp(o.dotFrac, 0.0, 1.0));
+
+    const auto perFrame = static_cast<std::size_t>(o.hitsPerFrame);
+    std::vector<RE::FormID> ids(frames * perFrame);
+    std::vector<Gauges::Hit> hits(ids.size());
+    {
+        struct Tagged {
+            RE::FormID id;
+            Gauges::Hit hit;
+        };
+        std::vector<Tagged> frame(perFrame);
+        SimClock at = host.clock;
+        for (std::uint64_t f = 0; f < frames; ++f) {
+            at.step(dt);
+            for (auto& t : frame) {
+                t.id = 0xFF000800u + static_cast<RE::FormID>(actorDist(rng));
+                t.hit.elem = static_cast<ERF_ElementHandle>(elemDist(rng));
+                t.hit.delta = isDot(rng) ? dotDelta(rng) : instDelta(rng);
+                t.hit.atH = at.nowH();
+            }
+            if (o.batch) std::ranges::stable_sort(frame, {}, &Tagged::id);
+            for (std::size_t k = 0; k < perFrame; ++k) {
+                ids[f * perFrame + k] = frame[k].id;
+                hits[f * perFrame + k] = frame[k].hit;
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> latNs;
+    latNs.reserve(hits.size());
+
+    using Clock = std::chrono::steady_clock;
+
+    const auto allocs0 = g_allocs.load();
+    const auto bytes0 = g_allocBytes.load();
+    const auto wall0 = Clock::now();
+
+    for (std::uint64_t f = 0; f < frames; ++f) {
+        host.clock.step(dt);
+
+        const std::span<const RE::FormID> frameIds(ids.data() + f * perFrame, perFrame);
+        const std::span<const Gauges::Hit> frame(hits.data() + f * perFrame, perFrame);
+        for (std::size_t i = 0; i < frame.size();) {
+            std::size_t j = i + 1;
+            if (o.batch) {
+                while (j < frame.size() && frameIds[j] == frameIds[i]) ++j;
+            }
+            const auto t0 = Clock::now();
+            Gauges::addBatch(frameIds[i], frame.subspan(i, j - i));
+            const auto t1 = Clock::now();
+            latNs.push_back(
+                static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+            i = j;
+        }
+    }
+
+    const double wallS = std::chrono::duration<double>(Clock::now() - wall0).count();
+    const auto allocs = g_allocs.load() - allocs0;
+    const auto bytes = g_allocBytes.load() - bytes0;
+
+    const auto calls = latNs.size();
+    const auto reactions = host.events.reactions;
+    const auto p50 = percentile(latNs, 0.50);
+    const auto p99 = percentile(latNs, 0.99);
+
+    std::printf(
+        "erf_bench actors=%d elements=%d reactions=%d fps=%d seconds=%.1f hits/frame=%d dot=%.2f batch=%d single=%d\n",
+        o.actors, o.elements, o.reactions, o.fps, o.seconds, o.hitsPerFrame, o.dotFrac, o.batch ? 1 : 0,
+        o.single ? 1 : 0);
+    std::printf("  hits         %llu in %.3f s wall (%.2f M hits/s)\n", static_cast<unsigned long long>(hits.size()),
+                wallS, wallS > 0.0 ? static_cast<double>(hits.size()) / wallS / 1e6 : 0.0);
+    std::printf("  add calls    %llu  p50 %llu ns  p99 %llu ns\n", static_cast<unsigned long long>(calls),
+                static_cast<unsigned long long>(p50), static_cast<unsigned long long>(p99));
+    std::printf("  reactions    %llu  (%.1f /s simulated, %.0f /s wall)\n",
+                static_cast<unsigned long long>(reactions), static_cast<double>(reactions) / o.seconds,
+                wallS > 0.0 ? static_cast<double>(reactions) / wallS : 0.0);
+    std::printf("  tracked      %zu actors at the end\n", Gauges::state().size());
+    std::printf("  allocations  %llu (%llu bytes) during the run\n", static_cast<unsigned long long>(allocs),
+                static_cast<unsigned long long>(bytes));
+
+    if (o.picks > 0) {
+        // 2..5 present elements per state with mixed magnitudes, so threshold checks both pass and fail.
+        constexpr std::size_t kStates = 1024;
+        const std::size_t stride = static_cast<std::size_t>(o.elements) + 1;
+        std::vector<std::uint8_t> totals(kStates * stride, 0);
+        std::vector<ERF_ElementHandle> present;
+        std::vector<std::uint32_t> presentStart{0};
+        std::uniform_int_distribution<int> countDist(2, std::min(5, o.elements));
+        std::uniform_int_distribution<int> valueDist(1, 100);
+        for (std::size_t s = 0; s < kStates; ++s) {
+            const int n = o.elements >= 2 ? countDist(rng) : 1;
+            for (int k = 0; k < n; ++k) {
+                const auto h = static_cast<ERF_ElementHandle>(elemDist(rng));
+                auto& v = totals[s * stride + h];
+                if (v == 0) present.push_back(h);
+                v = static_cast<std::uint8_t>(valueDist(rng));
+            }
+            presentStart.push_back(static_cast<std::uint32_t>(present.size()));
+        }
+
+        // The packed lanes only run on AVX2 CPUs; elsewhere both timings are the per-candidate walk.
+        const bool packedOn = ReactionRegistry::batchEval();
+        ReactionRegistry::setBatchEval(false);
+        const auto single = timePicks(o.picks, totals, present, presentStart, stride);
+        ReactionRegistry::setBatchEval(true);
+        const auto packed = timePicks(o.picks, totals, present, presentStart, stride);
+        ReactionRegistry::setBatchEval(packedOn);
+
+        const bool match = single.checksum == packed.checksum && single.hits == packed.hits;
+        std::printf("  pick eval    per-candidate %.1f ns  packed%s %.1f ns  (%d calls, %llu picked, results %s)\n",
+                    single.nsPerCall, ReactionRegistry::batchEval() ? "" : " (no AVX2)", packed.nsPerCall, o.picks,
+                    static_cast<unsigned long long>(packed.hits), match ? "match" : "DIFFER");
+        if (!match) return 1;
+    }
+
+    if (o.candidates > 0) {
+        // The same content in one-word and four-word masks shows what the wider mask costs by itself; the wide run
+        // registers more than 64 elements, which only the multi-word masks can hold.
+        auto sameContent = rng;
+        const auto narrow = timeCandidates<1>(o.candidates, o.elements, o.reactions, rng);
+        const auto widened = timeCandidates<4>(o.candidates, o.elements, o.reactions, sameContent);
+        const int wideN = std::min(o.wideElements, static_cast<int>(ElementMask<kMaxMaskWords>::kBits));
+        CandidateTimes wide;
+        switch (wideN > 64 ? MaskWordsFor(static_cast<std::size_t>(wideN)) : 0) {
+            case 0:
+                break;
+            case 2:
+                wide = timeCandidates<2>(o.candidates, wideN, o.reactions, rng);
+                break;
+            case 4:
+                wide = timeCandidates<4>(o.candidates, wideN, o.reactions, rng);
+                break;
+            default:
+                wide = timeCandidates<kMaxMaskWords>(o.candidates, wideN, o.reactions, rng);
+                break;
+        }
+        if (!narrow.same || !widened.same || !wide.same) {
+            std::fprintf(stderr, "erf_bench: the reaction index and the linear walk list different candidates\n");
+            return 1;
+        }
+
+        const auto report = [](const char* label, const CandidateTimes& c) {
+            std::printf("  %-12s index %.1f ns (%s), linear walk %.1f ns per query  (%.1f candidates each)\n", label,
+                        c.indexNs, c.dense ? "decision table" : "by high bit", c.linearNs, c.perQuery);
+        };
+        report("candidates", narrow);
+        report("  4 words", widened);
+        if (wideN > 64) {
+            char label[32];
+            std::snprintf(label, sizeof label, "  %d elems", wideN);
+            report(label, wide);
+        }
+    }
+
+    if (o.entryRounds > 0) {
+        const std::size_t nE = static_cast<std::size_t>(o.elements) + 1;
+        const std::size_t nR = static_cast<std::size_t>(o.reactions) + 1;
+        constexpr std::size_t nP = 1;
+        const auto actors = static_cast<std::size_t>(o.actors);
+
+        std::vector<std::uint16_t> touched(actors * kTouchedPerEntry);
+        for (auto& i : touched) i = static_cast<std::uint16_t>(elemDist(rng));
+        std::uint64_t sink = 0;
+
+        std::vector<VectorEntry> vecEntries;
+        vecEntries.reserve(actors);
+        const auto vec = timeEntries(
+            o.entryRounds, vecEntries, actors, touched, [&](auto& es) { es.emplace_back(nE, nR, nP); },
+            [](auto& es) { es.clear(); }, sink);
+
+        Gauges::Arena arena;
+        arena.configure(nE, nR, nP, static_cast<std::uint32_t>(actors));
+        const auto& L = arena.layout();
+        std::vector<ArenaEntry> arenaEntries;
+        arenaEntries.reserve(actors);
+        const auto slots = timeEntries(
+            o.entryRounds, arenaEntries, actors, touched,
+            [&](auto& es) {
+                const auto slot = arena.acquire();
+                es.push_back(ArenaEntry{slot, arena.view<std::uint8_t>(slot, L.offV, L.nE),
+                                        arena.view<float>(slot, L.offLastHitH, L.nE),
+                                        arena.view<float>(slot, L.offLastEvalH, L.nE)});
+            },
+            [&](auto& es) {
+                for (const auto& e : es) arena.release(e.slot);
+                es.clear();
+            },
+            sink);
+
+        std::printf("  entries      per-vector  acquire+release %.0f ns, sweep %.1f ns, %.1f allocations per entry\n",
+                    vec.churnNs, vec.sweepNs, vec.allocs);
+        std::printf("               arena       acquire+release %.0f ns, sweep %.1f ns, %.1f allocations per entry"
+                    "  (%zu B slots, checksum %llu)\n",
+                    slots.churnNs, slots.sweepNs, slots.allocs, L.stride, static_cast<unsigned long long>(sink));
+    }
+    return 0;
+}
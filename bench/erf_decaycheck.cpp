@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SimHost.h"
+#include "erf_element.h"
+
+using namespace ErfBench;
+
+// Randomized check of the present-only decay against the decay the plugin shipped before it. The reference below
+// is the pre-arena tickOne/tickAll, copied unchanged: one entry is decayed by Gauges::tickPresent, a reference
+// entry by the old full-slot sweep, both receive the same sets, and after every step their values, sums and
+// presence must agree. Every --drain-every steps it also steps a copy of the reference until it is empty and
+// checks that Gauges::drainAtH, which the deadline wheel wakes on, names that hour to within one wheel tick.
+namespace Baseline {
+    using Gauges::DecaySnapshot;
+    using Gauges::firstIndex;
+    using Gauges::handleFromIndex;
+    using Gauges::idx;
+
+    struct Entry {
+        std::vector<std::uint8_t> v;
+        std::vector<float> lastHitH;
+        std::vector<float> lastEvalH;
+        std::uint64_t presentMask = 0;
+        std::vector<ERF_ElementHandle> presentList;
+        int sumAll = 0;
+        int sumMix = 0;
+        std::vector<std::uint16_t> posInList;
+
+        explicit Entry(std::size_t nE) : v(nE, 0), lastHitH(nE, 0.f), lastEvalH(nE, 0.f), posInList(nE, 0xFFFF) {}
+    };
+
+    inline void makePresent(Entry& e, std::size_t i) {
+        if (i < firstIndex()) return;
+        if (i >= e.posInList.size()) return;
+        if (e.posInList[i] != 0xFFFF) return;
+        const ERF_ElementHandle h = handleFromIndex(i);
+
+        if (const auto bit = static_cast<unsigned>(h - 1); bit < 64) e.presentMask |= (UINT64_C(1) << bit);
+        e.posInList[i] = static_cast<std::uint16_t>(e.presentList.size());
+        e.presentList.push_back(h);
+    }
+    inline void dropPresent(Entry& e, std::size_t i) {
+        if (i < firstIndex()) return;
+        if (i >= e.posInList.size()) return;
+        auto pos = e.posInList[i];
+        if (pos == 0xFFFF) return;
+        const auto lastIdx = static_cast<std::uint16_t>(e.presentList.size() - 1);
+        const ERF_ElementHandle h = handleFromIndex(i);
+
+        if (const auto bit = static_cast<unsigned>(h - 1); bit < 64) e.presentMask &= ~(UINT64_C(1) << bit);
+        if (pos != lastIdx) {
+            const ERF_ElementHandle lastH = e.presentList[lastIdx];
+            e.presentList[pos] = lastH;
+            const std::size_t lastI = idx(lastH);
+            if (lastI < e.posInList.size()) e.posInList[lastI] = pos;
+        }
+        e.presentList.pop_back();
+        e.posInList[i] = 0xFFFF;
+    }
+    inline void onValChange(Entry& e, std::size_t i, int before, int after) {
+        if (i < firstIndex()) return;
+
+        const int delta = after - before;
+
+        e.sumAll += delta;
+        if (e.sumAll < 0) e.sumAll = 0;
+
+        if (delta != 0) {
+            const ERF_ElementHandle h = handleFromIndex(i);
+            if (h != 0) {
+                auto const& ER = ElementRegistry::get();
+                if (const ERF_ElementDesc* d = ER.get(h)) {
+                    if (!d->noMixInMixedMode) {
+                        e.sumMix += delta;
+                        if (e.sumMix < 0) e.sumMix = 0;
+                    }
+                } else {
+                    e.sumMix += delta;
+                    if (e.sumMix < 0) e.sumMix = 0;
+                }
+            }
+        }
+
+        const bool was = (before > 0);
+        const bool is = (after > 0);
+        if (was == is) return;
+        if (is)
+            makePresent(e, i);
+        else
+            dropPresent(e, i);
+    }
+
+    inline void tickOne(Entry& e, std::size_t i, float nowH, const DecaySnapshot& snap) {
+        auto& val = e.v[i];
+        auto& eval = e.lastEvalH[i];
+        const float hit = e.lastHitH[i];
+
+        if (val == 0) {
+            eval = nowH;
+            return;
+        }
+
+        const float rate = snap.ratePerHour;
+        if (rate <= 0.f) {
+            eval = nowH;
+            return;
+        }
+
+        const float graceEnd = hit + snap.graceHours;
+        if (nowH <= graceEnd) return;
+
+        const float startH = std::max(eval, graceEnd);
+        const float elapsedH = nowH - startH;
+        if (elapsedH <= 0.f) return;
+
+        const float decF = elapsedH * rate;
+        const auto decI = static_cast<int>(decF);
+        if (decI <= 0) return;
+
+        const auto before = static_cast<int>(val);
+        int next = before - decI;
+        if (next < 0) next = 0;
+        val = static_cast<std::uint8_t>(next);
+        if (next != before) onValChange(e, i, before, next);
+
+        const float rem = decF - static_cast<float>(decI);
+        eval = nowH - (rem / rate);
+    }
+
+    inline void tickAll(Entry& e, float nowH, const DecaySnapshot& snap) {
+        const auto n = e.v.size();
+        for (std::size_t i = firstIndex(); i < n; ++i) {
+            tickOne(e, i, nowH, snap);
+        }
+    }
+}
+
+namespace {
+    struct Options {
+        int elements = 40;
+        int steps = 200000;
+        int drainEvery = 500;
+        std::uint32_t seed = 1;
+    };
+
+    bool parseArg(std::string_view arg, Options& o) {
+        const auto eq = arg.find('=');
+        if (!arg.starts_with("--") || eq == std::string_view::npos) return false;
+        const auto key = arg.substr(2, eq - 2);
+        const std::string val{arg.substr(eq + 1)};
+
+        if (key == "elements")
+            o.elements = std::stoi(val);
+        else if (key == "steps")
+            o.steps = std::stoi(val);
+        else if (key == "drain-every")
+            o.drainEvery = std::stoi(val);
+        else if (key == "seed")
+            o.seed = static_cast<std::uint32_t>(std::stoul(val));
+        else
+            return false;
+        return true;
+    }
+
+    void set(Gauges::Entry& e, std::size_t i, int value, float nowH) {
+        const int before = e.v[i];
+        e.v[i] = static_cast<std::uint8_t>(value);
+        e.lastHitH[i] = nowH;
+        e.lastEvalH[i] = nowH;
+        Gauges::onValChange(e, i, before, value);
+    }
+
+    void set(Baseline::Entry& e, std::size_t i, int value, float nowH) {
+        const int before = e.v[i];
+        e.v[i] = static_cast<std::uint8_t>(value);
+        e.lastHitH[i] = nowH;
+        e.lastEvalH[i] = nowH;
+        Baseline::onValChange(e, i, before, value);
+    }
+
+    // lastEvalH only matters while an element holds a value: the old sweep stamps empty slots, and the new tickOne
+    // stamps an element it drains in one go with the current hour instead of backing out the remainder.
+    bool same(const Gauges::Entry& a, const Baseline::Entry& b, int step) {
+        bool ok = a.sumAll == b.sumAll && a.sumMix == b.sumMix && a.presentList.size() == b.presentList.size() &&
+                  a.presentMask[0] == b.presentMask;
+        for (std::size_t i = Gauges::firstIndex(); ok && i < a.v.size(); ++i) {
+            ok = a.v[i] == b.v[i] && (a.v[i] == 0 || a.lastEvalH[i] == b.lastEvalH[i]) &&
+                 (a.posInList[i] == 0xFFFF) == (b.posInList[i] == 0xFFFF);
+        }
+        if (!ok) std::fprintf(stderr, "erf_decaycheck: present-only and old-sweep decay diverge at step %d\n", step);
+        return ok;
+    }
+
+    struct DrainStats {
+        int checked = 0;
+        double worstLeadTicks = 0.0;
+        double worstLagTicks = 0.0;
+    };
+
+    // Steps a copy of the reference in random increments of at most half a wheel tick until it is empty, and
+    // compares the hour it got there with drainAtH: at most one tick later (or the drain wake would find a gauge
+    // still holding a value) and not earlier. The old sweep drifts on its own, though: each decrement backs the
+    // remainder out of a float hour, which moves it by up to an ulp of that hour, so both bounds widen by one ulp per
+    // decrement of the element that emptied last. Past ~60 game hours that drift alone can exceed a tick.
+    bool drainsOnTime(const Gauges::Entry& a, Baseline::Entry ref, float nowH, const Gauges::DecaySnapshot& snap,
+                      std::mt19937& rng, int step, DrainStats& stats) {
+        const float drainAt = Gauges::drainAtH(a, snap);
+        if (a.sumAll <= 0 || !std::isfinite(drainAt)) return true;
+
+        constexpr double kTickH = 1.0 / Gauges::kHourTicksPerHour;
+        constexpr double kGiveUpTicks = 1000.0;
+        std::uniform_real_distribution<double> dtDist(kTickH / 64.0, kTickH / 2.0);
+        const auto ulp = [](float x) { return std::nextafter(x, std::numeric_limits<float>::infinity()) - x; };
+
+        // Elements drift independently, so the allowance follows the element that took the most decrements.
+        double h = nowH;
+        std::vector<int> decrements(ref.v.size(), 0);
+        std::vector<std::uint8_t> before;
+        while (ref.sumAll > 0 && h <= drainAt + kGiveUpTicks * kTickH) {
+            h += dtDist(rng);
+            before = ref.v;
+            Baseline::tickAll(ref, static_cast<float>(h), snap);
+            for (std::size_t i = 0; i < before.size(); ++i) decrements[i] += ref.v[i] != before[i];
+        }
+        const auto emptyAt = static_cast<float>(h);
+        const double drift = (std::ranges::max(decrements) + 4.0) * ulp(emptyAt);
+
+        if (ref.sumAll > 0 || emptyAt < drainAt - drift || emptyAt > drainAt + kTickH + drift) {
+            std::fprintf(stderr,
+                         "erf_decaycheck: at step %d drainAtH says %.6f h but the old sweep %s at %.6f h "
+                         "(tick %.6f h, drift allowance %.6f h)\n",
+                         step, drainAt, ref.sumAll > 0 ? "still holds gauge" : "drained", emptyAt, kTickH, drift);
+            return false;
+        }
+        ++stats.checked;
+        stats.worstLeadTicks = std::max(stats.worstLeadTicks, (drainAt - emptyAt) / kTickH);
+        stats.worstLagTicks = std::max(stats.worstLagTicks, (emptyAt - drainAt) / kTickH);
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        if (!parseArg(argv[i], o)) {
+            std::fprintf(stderr, "usage: erf_decaycheck [--elements=M] [--steps=N] [--drain-every=N] [--seed=N]\n");
+            return 2;
+        }
+    }
+    o.elements = std::clamp(o.elements, 1, 4096);
+
+    std::mt19937 rng{o.seed};
+
+    auto& ER = ElementRegistry::get();
+    std::bernoulli_distribution noMix(0.2);
+    for (int i = 0; i < o.elements; ++i) {
+        ERF_ElementDesc d{};
+        d.name = "Element" + std::to_string(i);
+        d.colorRGB = 0xFFFFFF;
+        d.keyword = nullptr;
+        d.noMixInMixedMode = noMix(rng);
+        ER.registerElement(d);
+    }
+    ER.freeze();
+    ReactionRegistry::get().freeze();
+
+    SimHost host;
+    host.bind();
+
+    constexpr RE::FormID kPresentOnly = 0xFF000800u;
+    Gauges::acquire(kPresentOnly);
+    auto& a = Gauges::state().find(kPresentOnly)->second;
+    Baseline::Entry ref(a.v.size());
+
+    std::uniform_int_distribution<int> elemDist(1, o.elements);
+    std::uniform_int_distribution<int> valueDist(0, 100);
+    std::uniform_int_distribution<int> opsDist(0, 4);
+    std::uniform_real_distribution<double> dtDist(0.0, 2.0);
+    std::bernoulli_distribution longGap(0.02);
+    std::bernoulli_distribution tsChange(0.001);
+    std::uniform_real_distribution<float> tsDist(1.0f, 60.0f);
+
+    std::uint64_t nonZero = 0;
+    DrainStats drains;
+    for (int step = 0; step < o.steps; ++step) {
+        // Mostly frame-sized steps, with the odd long gap so whole gauges drain between ticks.
+        host.clock.step(longGap(rng) ? dtDist(rng) * 30.0 : dtDist(rng) * 0.05);
+        if (tsChange(rng)) host.clock.ts = tsDist(rng);
+
+        const float nowH = host.clock.nowH();
+        const auto snap = Gauges::SnapshotDecay();
+        Gauges::tickPresent(a, nowH, snap);
+        Baseline::tickAll(ref, nowH, snap);
+        if (!same(a, ref, step)) return 1;
+
+        for (int k = opsDist(rng); k > 0; --k) {
+            const auto i = Gauges::idx(static_cast<ERF_ElementHandle>(elemDist(rng)));
+            const int value = valueDist(rng);
+            set(a, i, value, nowH);
+            set(ref, i, value, nowH);
+        }
+        if (!same(a, ref, step)) return 1;
+        nonZero += a.presentList.size();
+
+        if (o.drainEvery > 0 && step % o.drainEvery == 0 && a.sumAll > 0) {
+            if (!drainsOnTime(a, ref, nowH, snap, rng, step, drains)) return 1;
+        }
+    }
+
+    std::printf("erf_decaycheck elements=%d steps=%d seed=%u: identical (%.2f present elements on average)\n",
+                o.elements, o.steps, o.seed, static_cast<double>(nonZero) / std::max(1, o.steps));
+    std::printf("  drainAtH     %d drains checked; the old sweep emptied %.2f ticks before it to %.2f after\n",
+                drains.checked, drains.worstLeadTicks, drains.worstLagTicks);
+    return 0;
+}
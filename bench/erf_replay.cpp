@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "GaugeTraceFormat.h"
+#include "SimHost.h"
+#include "erf_element.h"
+#include "erf_reaction.h"
+
+using namespace ErfBench;
+
+namespace {
+    struct Reader {
+        const std::vector<char>& buf;
+        std::size_t at = 0;
+
+        template <class T>
+        bool get(T& out) {
+            if (at + sizeof(T) > buf.size()) return false;
+            std::memcpy(&out, buf.data() + at, sizeof(T));
+            at += sizeof(T);
+            return true;
+        }
+    };
+
+    bool loadContent(Reader& in, const GaugeTrace::FileHeader& h) {
+        auto& ER = ElementRegistry::get();
+        for (std::uint16_t i = 0; i < h.numElements; ++i) {
+            std::uint8_t noMix = 0;
+            if (!in.get(noMix)) return false;
+            ERF_ElementDesc d{};
+            d.name = "Element" + std::to_string(i + 1);
+            d.colorRGB = 0xFFFFFF;
+            d.keyword = nullptr;
+            d.noMixInMixedMode = noMix != 0;
+            ER.registerElement(d);
+        }
+        ER.freeze();
+
+        auto& RR = ReactionRegistry::get();
+        for (std::uint16_t r = 0; r < h.numReactions; ++r) {
+            GaugeTrace::ReactionRow row{};
+            if (!in.get(row)) return false;
+            ERF_ReactionDesc d{};
+            d.name = "Reaction" + std::to_string(r + 1);
+            d.minPctEach = row.minPctEach;
+            d.minSumSelected = row.minSumSelected;
+            d.cooldownSeconds = row.cooldownSeconds;
+            d.elementLockoutSeconds = row.elementLockoutSeconds;
+            d.ordered = row.ordered != 0;
+            for (std::uint16_t k = 0; k < row.elementCount; ++k) {
+                std::uint16_t eh = 0;
+                if (!in.get(eh)) return false;
+                d.elements.push_back(eh);
+            }
+            RR.registerReaction(d);
+        }
+        RR.freeze();
+        return true;
+    }
+
+    std::uint64_t percentile(std::vector<std::uint32_t>& ns, double p) {
+        if (ns.empty()) return 0;
+        const auto k = static_cast<std::size_t>(p * static_cast<double>(ns.size() - 1));
+        std::ranges::nth_element(ns, ns.begin() + static_cast<std::ptrdiff_t>(k));
+        return ns[k];
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: erf_replay <ERFGauges.trace> [--dump]\n");
+        return 2;
+    }
+    const bool dump = argc > 2 && std::string_view{argv[2]} == "--dump";
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file) {
+        std::fprintf(stderr, "erf_replay: cannot open %s\n", argv[1]);
+        return 1;
+    }
+    const std::vector<char> buf{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+    Reader in{buf};
+    GaugeTrace::FileHeader h{};
+    if (!in.get(h) || h.magic != GaugeTrace::kMagic || h.version != GaugeTrace::kVersion ||
+        h.recordSize != sizeof(GaugeTrace::Record)) {
+        std::fprintf(stderr, "erf_replay: %s is not a v%u gauge trace\n", argv[1], GaugeTrace::kVersion);
+        return 1;
+    }
+    if (!loadContent(in, h)) {
+        std::fprintf(stderr, "erf_replay: truncated content tables\n");
+        return 1;
+    }
+
+    std::vector<GaugeTrace::Record> records((buf.size() - in.at) / sizeof(GaugeTrace::Record));
+    std::memcpy(records.data(), buf.data() + in.at, records.size() * sizeof(GaugeTrace::Record));
+
+    std::vector<Fired> recorded;
+    std::vector<Fired> replayed;
+
+    // Recorded hits carry what reached the gauge, so replay runs with unit multipliers and no states.
+    SimHost host;
+    host.clock.ts = std::max(h.timescale, 0.001f);
+    host.tuning.isSingle = h.isSingle != 0;
+    host.tuning.maxReactionsPerTrigger = h.maxReactionsPerTrigger;
+    host.events.fired = &replayed;
+    host.bind();
+
+    std::vector<Gauges::Hit> batch;
+    std::vector<std::uint32_t> latNs;
+    std::uint64_t hits = 0;
+
+    using Clock = std::chrono::steady_clock;
+    const auto wall0 = Clock::now();
+
+    for (std::size_t i = 0; i < records.size();) {
+        const auto& r = records[i];
+        if (r.kind == GaugeTrace::RecordKind::kReaction) {
+            recorded.push_back(Fired{r.actor, r.reaction});
+            ++i;
+            continue;
+        }
+
+        // Hits drained in the same frame for the same actor share a timestamp; replay them as one batch.
+        batch.clear();
+        std::size_t j = i;
+        for (; j < records.size(); ++j) {
+            const auto& n = records[j];
+            if (n.kind != GaugeTrace::RecordKind::kHit || n.actor != r.actor || n.rtS != r.rtS) break;
+            if (n.applied > 0) batch.push_back(Gauges::Hit{n.elem, n.applied, n.hours});
+        }
+        hits += j - i;
+        i = j;
+        if (batch.empty()) continue;
+
+        host.clock.set(r.rtS, r.hours);
+        const auto t0 = Clock::now();
+        Gauges::addBatch(r.actor, batch);
+        const auto t1 = Clock::now();
+        latNs.push_back(
+            static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+    }
+
+    const double wallS = std::chrono::duration<double>(Clock::now() - wall0).count();
+
+    std::size_t same = 0;
+    while (same < recorded.size() && same < replayed.size() && recorded[same].id == replayed[same].id &&
+           recorded[same].reaction == replayed[same].reaction) {
+        ++same;
+    }
+
+    const auto calls = latNs.size();
+    const auto p50 = percentile(latNs, 0.50);
+    const auto p99 = percentile(latNs, 0.99);
+
+    std::printf("erf_replay %s: %u elements, %u reactions, %s mode, timescale %.1f, up to %u reactions per trigger, "
+                "%zu records\n",
+                argv[1], h.numElements, h.numReactions, h.isSingle ? "single" : "mixed", h.timescale,
+                h.maxReactionsPerTrigger, records.size());
+    std::printf("  hits         %llu in %.3f s wall\n", static_cast<unsigned long long>(hits), wallS);
+    std::printf("  add calls    %llu  p50 %llu ns  p99 %llu ns\n", static_cast<unsigned long long>(calls),
+                static_cast<unsigned long long>(p50), static_cast<unsigned long long>(p99));
+    std::printf("  reactions    recorded %zu, replayed %zu, identical prefix %zu\n", recorded.size(), replayed.size(),
+                same);
+    if (same < std::max(recorded.size(), replayed.size())) {
+        std::printf("  first divergence at reaction #%zu\n", same);
+    }
+
+    if (dump) {
+        for (const auto& f : replayed) std::printf("%08X %u\n", f.id, static_cast<unsigned>(f.reaction));
+    }
+    return same == recorded.size() && same == replayed.size() ? 0 : 3;
+}
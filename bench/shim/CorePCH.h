@@ -0,0 +1,11 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "RE/Skyrim.h"
+
+using namespace std::literals;
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+// The portable core only names these CommonLibSSE types, so it gets by with stand-ins. Actor is never
+// dereferenced outside the plugin; callback signatures just pass it through.
+namespace RE {
+    using FormID = std::uint32_t;
+
+    class Actor;
+
+    class BGSKeyword {
+    public:
+        FormID GetFormID() const noexcept { return formID; }
+
+        FormID formID{0};
+    };
+}
@@ -65,6 +65,10 @@ namespace ERF {
         bool nh = loadBool(ini, "HUD", "NpcHorizontal", true);
         double psp = loadDouble(ini, "HUD", "PlayerSpacing", 40.0);
         double nsp = loadDouble(ini, "HUD", "NpcSpacing", 40.0);
+        double budget = loadDouble(ini, "HUD", "FrameBudgetUs", 1000.0);
+        double maxDist = loadDouble(ini, "HUD", "MaxDistance", 0.0);
+        double maxVis = loadDouble(ini, "HUD", "MaxVisible", 0.0);
+        bool trace = loadBool(ini, "Debug", "TraceGauges", false);
 
         enabled.store(en, std::memory_order_relaxed);
         hudEnabled.store(hud, std::memory_order_relaxed);
@@ -84,6 +88,10 @@ namespace ERF {
         npcHorizontal.store(nh, std::memory_order_relaxed);
         playerSpacing.store(static_cast<float>(psp < 0 ? 0 : psp), std::memory_order_relaxed);
         npcSpacing.store(static_cast<float>(nsp < 0 ? 0 : nsp), std::memory_order_relaxed);
+        hudFrameBudgetUs.store(static_cast<int>(budget < 0 ? 0 : budget), std::memory_order_relaxed);
+        hudMaxDistance.store(static_cast<float>(maxDist < 0 ? 0 : maxDist), std::memory_order_relaxed);
+        hudMaxVisible.store(static_cast<int>(maxVis < 0 ? 0 : maxVis), std::memory_order_relaxed);
+        traceGauges.store(trace, std::memory_order_relaxed);
     }
 
     void Config::Save() const {
@@ -109,6 +117,11 @@ namespace ERF {
         ini.SetBoolValue("HUD", "NpcHorizontal", npcHorizontal.load(std::memory_order_relaxed));
         ini.SetDoubleValue("HUD", "PlayerSpacing", playerSpacing.load(std::memory_order_relaxed));
         ini.SetDoubleValue("HUD", "NpcSpacing", npcSpacing.load(std::memory_order_relaxed));
+        ini.SetDoubleValue("HUD", "FrameBudgetUs",
+                           static_cast<double>(hudFrameBudgetUs.load(std::memory_order_relaxed)));
+        ini.SetDoubleValue("HUD", "MaxDistance", hudMaxDistance.load(std::memory_order_relaxed));
+        ini.SetDoubleValue("HUD", "MaxVisible", static_cast<double>(hudMaxVisible.load(std::memory_order_relaxed)));
+        ini.SetBoolValue("Debug", "TraceGauges", traceGauges.load(std::memory_order_relaxed));
 
         std::error_code ec;
         std::filesystem::create_directories(path.parent_path(), ec);
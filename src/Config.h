@@ -21,6 +21,11 @@ namespace ERF {
         std::atomic<bool> npcHorizontal{true};
         std::atomic<float> playerSpacing{40.0};
         std::atomic<float> npcSpacing{40.0};
+        std::atomic<int> hudFrameBudgetUs{1000};
+        std::atomic<float> hudMaxDistance{0.0f};
+        std::atomic<int> hudMaxVisible{0};
+
+        std::atomic<bool> traceGauges{false};
 
         void Load();
         void Save() const;
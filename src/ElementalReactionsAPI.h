@@ -14,8 +14,10 @@ namespace RE {
 }
 
 // ===================== API version =====================
-// Bumped whenever the public interface changes in a breaking way.
-inline constexpr std::uint32_t ERF_API_VERSION = 2;
+// Bumped whenever the public interface changes in a breaking way or grows new entries.
+// 3 appended the bulk state entries; a version 2 request still gets the same table minus those.
+inline constexpr std::uint32_t ERF_API_VERSION = 3;
+inline constexpr std::uint32_t ERF_API_VERSION_MIN = 2;
 
 // ===================== Public handles =====================
 // Opaque numeric handles returned by the registration functions.
@@ -125,7 +127,7 @@ struct ERF_StateDesc_Public {
 
 // Main API structure for version ERF_API_VERSION.
 struct ERF_API_V1 {
-    std::uint32_t version;  // Must be equal to ERF_API_VERSION.
+    std::uint32_t version;  // The version that was requested (ERF_API_VERSION_MIN..ERF_API_VERSION).
 
     // 1) Registration
     // Called during the registration window (before Freeze) to declare
@@ -157,6 +159,17 @@ struct ERF_API_V1 {
     bool (*IsRegistrationOpen)();               // True while registration window is open.
     bool (*IsFrozen)();                         // True after registries have been frozen.
     void (*FreezeNow)();                        // Force an immediate freeze of all registries.
+
+    // 5) Bulk states (version >= 3)
+    // Appended after the V1 fields so older consumers keep the same layout. A table handed out for
+    // version 2 leaves both pointers null.
+    //  - SetStatesBulk replaces the actor's whole state set with `states[0..count)`.
+    //  - SetStateForActors flips one state on many actors under a single lock;
+    //    returns how many actors actually changed.
+    // Gauge multipliers are only recomputed for actors whose product changed.
+    bool (*SetStatesBulk)(RE::Actor*, const ERF_StateHandle* states, std::uint32_t count);
+    std::uint32_t (*SetStateForActors)(RE::Actor* const* actors, std::uint32_t count, ERF_StateHandle state,
+                                       bool active);
 };
 
 // ===================== Helper: resolve/cache the API pointer =====================
@@ -172,7 +185,7 @@ using ERF_RequestPluginAPI_Fn = void* (*)(std::uint32_t);
 
 // Convenience helper to fetch and cache the API pointer.
 // Returns nullptr if the provider DLL or the requested version
-// could not be found or does not match ERF_API_VERSION.
+// could not be found. Pass 2 to run against providers that predate the bulk entries.
 [[nodiscard]] inline ERF_API_V1* ERF_GetAPI(std::uint32_t v = ERF_API_VERSION) noexcept {
     static HMODULE s_mod = []() noexcept { return ::GetModuleHandleA(ERF_PROVIDER_DLL_NAME); }();
     if (!s_mod) return nullptr;
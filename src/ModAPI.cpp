@@ -4,7 +4,9 @@
 #include "RE/Skyrim.h"
 #include "SKSE/SKSE.h"
 #include "elemental_reactions/ElementalGauges.h"
+#include "elemental_reactions/ElementalGaugesHook.h"
 #include "elemental_reactions/ElementalStates.h"
+#include "elemental_reactions/GaugeTrace.h"
 #include "elemental_reactions/erf_element.h"
 #include "elemental_reactions/erf_preeffect.h"
 #include "elemental_reactions/erf_reaction.h"
@@ -26,11 +28,17 @@ namespace {
         PreEffectRegistry::get().freeze();
 
         ElementalGauges::BuildColorLUTOnce();
+        ElementalGaugesHook::BuildEffectClassCache();
 
         g_caps.numElements = static_cast<std::uint16_t>(ElementRegistry::get().size());
         g_caps.numStates = static_cast<std::uint16_t>(StateRegistry::get().size());
         g_caps.numReactions = static_cast<std::uint16_t>(ReactionRegistry::get().size());
+        g_caps.numPreEffects = static_cast<std::uint16_t>(PreEffectRegistry::get().size());
         g_caps.ready = true;
+
+        if (ERF::GetConfig().traceGauges.load(std::memory_order_relaxed)) {
+            GaugeTrace::Start();
+        }
     }
 }
 
@@ -102,7 +110,7 @@ static void API_SetElementStateMultiplier(ERF_ElementHandle elem, ERF_StateHandl
         return;
     }
 
-    StateRegistry::get().setElementMultipliers(state, elem, gaugeMult, healthMult);
+    ElementalStates::SetElementMultipliers(state, elem, gaugeMult, healthMult);
 }
 
 static bool API_ActivateState(RE::Actor* actor, ERF_StateHandle state) noexcept {
@@ -112,6 +120,16 @@ static bool API_DeactivateState(RE::Actor* actor, ERF_StateHandle state) noexcep
     return ElementalStates::SetActive(actor, state, false);
 }
 
+static bool API_SetStatesBulk(RE::Actor* actor, const ERF_StateHandle* states, std::uint32_t count) noexcept {
+    if (!states && count != 0) return false;
+    return ElementalStates::SetStates(actor, std::span<const ERF_StateHandle>(states, count));
+}
+static std::uint32_t API_SetStateForActors(RE::Actor* const* actors, std::uint32_t count, ERF_StateHandle state,
+                                           bool active) noexcept {
+    if (!actors || count == 0) return 0;
+    return ElementalStates::SetStateFor(std::span<RE::Actor* const>(actors, count), state, active);
+}
+
 static bool API_BeginBatchRegistration() noexcept {
     if (!g_reg_open.load(std::memory_order_acquire)) return false;
     g_reg_barrier.fetch_add(1, std::memory_order_acq_rel);
@@ -136,7 +154,18 @@ static ERF_API_V1 g_api = {ERF_API_VERSION,
                            &API_SetFreezeTimeoutMs,
                            &API_IsRegistrationOpen,
                            &API_IsFrozen,
-                           &API_FreezeNow};
+                           &API_FreezeNow,
+                           &API_SetStatesBulk,
+                           &API_SetStateForActors};
+
+// Version 2 consumers check the version field and never read past FreezeNow.
+static ERF_API_V1 g_apiV2 = [] {
+    auto api = g_api;
+    api.version = ERF_API_VERSION_MIN;
+    api.SetStatesBulk = nullptr;
+    api.SetStateForActors = nullptr;
+    return api;
+}();
 
 void ERF::API::OpenRegistrationWindowAndScheduleFreeze() {
     g_reg_open.store(true, std::memory_order_release);
@@ -155,7 +184,11 @@ void ERF::API::OpenRegistrationWindowAndScheduleFreeze() {
     }).detach();
 }
 
-ERF_API_V1* ERF::API::Get() { return &g_api; }
+ERF_API_V1* ERF::API::Get(std::uint32_t version) {
+    if (version == ERF_API_VERSION) return &g_api;
+    if (version == ERF_API_VERSION_MIN) return &g_apiV2;
+    return nullptr;
+}
 
 const ERF::API::FrozenCaps& ERF::API::Caps() {
     if (!g_caps.ready) {
@@ -2,7 +2,8 @@
 #include "ElementalReactionsAPI.h"
 
 namespace ERF::API {
-    ERF_API_V1* Get();
+    // nullptr for versions this build does not serve.
+    ERF_API_V1* Get(std::uint32_t version = ERF_API_VERSION);
     void OpenRegistrationWindowAndScheduleFreeze();
 
     struct FrozenCaps {
@@ -12,12 +12,21 @@ namespace {
         RE::NiAVObject* node{nullptr};
     };
 
+    // The torso node name comes from the race, so the entry remembers which 3D root it was resolved under and
+    // resolves again after a race swap or a 3D reload.
+    struct TorsoEntry {
+        RE::NiAVObject* root{nullptr};
+        RE::NiAVObject* node{nullptr};
+    };
+
     static std::unordered_map<RE::FormID, HeadEntry> g_headCache;
+    static std::unordered_map<RE::FormID, TorsoEntry> g_torsoCache;
     static bool g_resvd = false;
 
     inline void EnsureReserveOnce() {
         if (!g_resvd) {
             g_headCache.reserve(128);
+            g_torsoCache.reserve(128);
             g_resvd = true;
         }
     }
@@ -62,6 +71,31 @@ namespace {
         g_headCache.emplace(key, HeadEntry{nullptr});
         return nullptr;
     }
+
+    inline RE::NiAVObject* FindTorsoNode(RE::Actor* a, RE::NiAVObject* root) noexcept {
+        const RE::TESRace* race = a->GetRace();
+        const RE::BGSBodyPartData* bodyPartData = race ? race->bodyPartData : nullptr;
+        const RE::BGSBodyPart* bodyPart = bodyPartData ? bodyPartData->parts[0] : nullptr;
+        if (!bodyPart || bodyPart->targetName.empty()) return nullptr;
+        return root->GetObjectByName(bodyPart->targetName);
+    }
+
+    inline RE::NiAVObject* GetTorsoNodeFast_(RE::Actor* a) {
+        if (!a) return nullptr;
+        EnsureReserveOnce();
+
+        RE::NiAVObject* root = a->Get3D2();
+        auto& e = g_torsoCache[a->GetFormID()];
+        if (!root) {
+            e = {};
+            return nullptr;
+        }
+        if (e.root == root && (!e.node || e.node->parent)) return e.node;
+
+        e.root = root;
+        e.node = FindTorsoNode(a, root);
+        return e.node;
+    }
 }
 
 bool Utils::GetHeadPosFast(RE::Actor* a, RE::NiPoint3& out) {
@@ -80,6 +114,24 @@ bool Utils::GetHeadPosFast(RE::Actor* a, RE::NiPoint3& out) {
     return false;
 }
 
+bool Utils::GetTorsoPosFast(RE::Actor* a, RE::NiPoint3& out) {
+    if (RE::NiAVObject const* torso = GetTorsoNodeFast_(a)) {
+        out = torso->world.translate;
+        return true;
+    }
+    return false;
+}
+
+// Same preference order as GetTargetPos(handle, pos, true), without the per-call name search.
+bool Utils::GetAnchorPosFast(RE::Actor* a, RE::NiPoint3& out) {
+    if (!a || !a->Get3D2()) return false;
+    if (GetTorsoPosFast(a, out)) return true;
+    if (GetHeadPosFast(a, out)) return true;
+    if (GetBoundTopPos(a, out)) return true;
+    out = a->GetLookingAtLocation();
+    return true;
+}
+
 bool Utils::GetNodePosition(RE::ActorPtr a_actor, const char* a_nodeName, RE::NiPoint3& point) {
     if (!a_actor) return false;
     if (!a_nodeName || a_nodeName[0] == '\0') return false;
@@ -146,5 +198,6 @@ void Utils::HeadCacheReserve(std::size_t n) noexcept {
 
 void Utils::HeadCacheClearAll() noexcept {
     g_headCache.clear();
+    g_torsoCache.clear();
     g_resvd = false;
 }
\ No newline at end of file
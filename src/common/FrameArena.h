@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator rewound once per frame. A frame that outgrows the block spills into extra blocks, and the next
+// reset folds them into one block sized for that frame, so a steady frame never touches the heap.
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t initialBytes = 16 * 1024) : _cap(Round(initialBytes)) {}
+
+    template <class T>
+    std::span<T> take(std::size_t n) {
+        static_assert(std::is_trivially_destructible_v<T>);
+        static_assert(alignof(T) <= alignof(std::max_align_t));
+        if (n == 0) return {};
+        T* p = static_cast<T*>(bump(n * sizeof(T), alignof(T)));
+        std::uninitialized_value_construct_n(p, n);
+        return {p, n};
+    }
+
+    void reset() {
+        if (!_block || !_spill.empty()) {
+            _cap = std::max(_cap, Round((_used + _spilled) * 2));
+            _block = std::make_unique<std::max_align_t[]>(_cap / sizeof(std::max_align_t));
+            _spill.clear();
+        }
+        _used = 0;
+        _spilled = 0;
+    }
+
+    std::size_t capacity() const noexcept { return _cap; }
+
+private:
+    static std::size_t Round(std::size_t bytes) {
+        constexpr std::size_t kWord = sizeof(std::max_align_t);
+        return std::max<std::size_t>(kWord, (bytes + kWord - 1) / kWord * kWord);
+    }
+
+    void* bump(std::size_t bytes, std::size_t align) {
+        const std::size_t at = (_used + align - 1) & ~(align - 1);
+        if (_block && at + bytes <= _cap) {
+            _used = at + bytes;
+            return reinterpret_cast<std::byte*>(_block.get()) + at;
+        }
+        const std::size_t size = Round(bytes);
+        _spilled += size;
+        _spill.push_back(std::make_unique<std::max_align_t[]>(size / sizeof(std::max_align_t)));
+        return _spill.back().get();
+    }
+
+    std::unique_ptr<std::max_align_t[]> _block;
+    std::vector<std::unique_ptr<std::max_align_t[]>> _spill;
+    std::size_t _cap;
+    std::size_t _used{0};
+    std::size_t _spilled{0};
+};
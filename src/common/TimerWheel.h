@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+template <class T, unsigned Bits0 = 8, unsigned Bits1 = 6>
+class TimerWheel {
+public:
+    static constexpr std::uint64_t kSlots0 = std::uint64_t{1} << Bits0;
+    static constexpr std::uint64_t kSlots1 = std::uint64_t{1} << Bits1;
+    static constexpr std::uint64_t kMask0 = kSlots0 - 1;
+    static constexpr std::uint64_t kMask1 = kSlots1 - 1;
+    static constexpr std::uint64_t kSpan = kSlots0 * kSlots1;
+
+    void clear(std::uint64_t nowTick = 0) {
+        for (auto& b : _l0) b.clear();
+        for (auto& b : _l1) b.clear();
+        _far.clear();
+        _now = nowTick;
+        _size = 0;
+    }
+
+    std::size_t size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0; }
+    std::uint64_t now() const noexcept { return _now; }
+
+    void schedule(std::uint64_t dueTick, const T& payload) {
+        ++_size;
+        place(Node{dueTick, payload});
+    }
+
+    template <class F>
+    void advance(std::uint64_t nowTick, F&& onExpire) {
+        if (nowTick <= _now || _size == 0) {
+            if (nowTick > _now) _now = nowTick;
+            return;
+        }
+
+        if (nowTick - _now >= kSpan) {
+            jump(nowTick, onExpire);
+            return;
+        }
+
+        while (_now < nowTick) {
+            const std::uint64_t t = _now + 1;
+
+            if ((t & (kSpan - 1)) == 0) {
+                replaceAll(_far);
+            }
+            if ((t & kMask0) == 0) {
+                replaceAll(_l1[(t >> Bits0) & kMask1]);
+            }
+            _now = t;
+
+            auto& bucket = _l0[t & kMask0];
+            if (bucket.empty()) continue;
+
+            _fire.clear();
+            _fire.swap(bucket);
+            _size -= _fire.size();
+            for (const auto& n : _fire) onExpire(n.payload);
+        }
+    }
+
+private:
+    struct Node {
+        std::uint64_t due;
+        T payload;
+    };
+
+    void place(const Node& n) {
+        const std::uint64_t due = (n.due > _now) ? n.due : (_now + 1);
+        const std::uint64_t delta = due - _now;
+
+        if (delta <= kSlots0) {
+            _l0[due & kMask0].push_back(Node{due, n.payload});
+        } else if (delta < kSpan) {
+            _l1[(due >> Bits0) & kMask1].push_back(Node{due, n.payload});
+        } else {
+            _far.push_back(Node{due, n.payload});
+        }
+    }
+
+    void replaceAll(std::vector<Node>& bucket) {
+        if (bucket.empty()) return;
+        _move.clear();
+        _move.swap(bucket);
+        for (const auto& n : _move) place(n);
+    }
+
+    template <class F>
+    void jump(std::uint64_t nowTick, F& onExpire) {
+        _move.clear();
+        for (auto& b : _l0) {
+            _move.insert(_move.end(), b.begin(), b.end());
+            b.clear();
+        }
+        for (auto& b : _l1) {
+            _move.insert(_move.end(), b.begin(), b.end());
+            b.clear();
+        }
+        _move.insert(_move.end(), _far.begin(), _far.end());
+        _far.clear();
+
+        _now = nowTick;
+        _fire.clear();
+        for (const auto& n : _move) {
+            if (n.due <= nowTick) {
+                _fire.push_back(n);
+            } else {
+                place(n);
+            }
+        }
+        _size -= _fire.size();
+        for (const auto& n : _fire) onExpire(n.payload);
+    }
+
+    std::array<std::vector<Node>, kSlots0> _l0{};
+    std::array<std::vector<Node>, kSlots1> _l1{};
+    std::vector<Node> _far;
+    std::vector<Node> _fire;
+    std::vector<Node> _move;
+    std::uint64_t _now{0};
+    std::size_t _size{0};
+};
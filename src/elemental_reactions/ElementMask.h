@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__AVX__)
+    #include <immintrin.h>
+    #define ERF_MASK_AVX 1
+#elif defined(__SSE4_1__)
+    #include <smmintrin.h>
+    #define ERF_MASK_SSE41 1
+#endif
+
+// Element presence bitset. Bit (h - 1) stands for element handle h, matching the 64-bit masks it generalises.
+template <std::size_t Words>
+struct ElementMask {
+    static_assert(Words > 0);
+    static constexpr std::size_t kWords = Words;
+    static constexpr std::size_t kBits = Words * 64;
+
+    std::array<std::uint64_t, Words> w{};
+
+    void set(std::size_t bit) noexcept {
+        if (bit < kBits) w[bit >> 6] |= std::uint64_t{1} << (bit & 63);
+    }
+    void reset(std::size_t bit) noexcept {
+        if (bit < kBits) w[bit >> 6] &= ~(std::uint64_t{1} << (bit & 63));
+    }
+    bool test(std::size_t bit) const noexcept { return bit < kBits && ((w[bit >> 6] >> (bit & 63)) & 1u); }
+
+    bool any() const noexcept {
+        std::uint64_t acc = 0;
+        for (auto x : w) acc |= x;
+        return acc != 0;
+    }
+
+    int popcount() const noexcept {
+        int n = 0;
+        for (auto x : w) n += std::popcount(x);
+        return n;
+    }
+
+    int highBit() const noexcept {
+        for (std::size_t i = Words; i-- > 0;) {
+            if (w[i]) return static_cast<int>(i * 64 + 63 - std::countl_zero(w[i]));
+        }
+        return -1;
+    }
+
+    bool subsetOf(const ElementMask& o) const noexcept {
+#if defined(ERF_MASK_AVX)
+        if constexpr (Words % 4 == 0) {
+            for (std::size_t i = 0; i < Words; i += 4) {
+                const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w.data() + i));
+                const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(o.w.data() + i));
+                if (!_mm256_testc_si256(b, a)) return false;
+            }
+            return true;
+        }
+#endif
+#if defined(ERF_MASK_AVX) || defined(ERF_MASK_SSE41)
+        if constexpr (Words % 2 == 0) {
+            for (std::size_t i = 0; i < Words; i += 2) {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w.data() + i));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(o.w.data() + i));
+                if (!_mm_testc_si128(b, a)) return false;
+            }
+            return true;
+        }
+#endif
+        std::uint64_t extra = 0;
+        for (std::size_t i = 0; i < Words; ++i) extra |= w[i] & ~o.w[i];
+        return extra == 0;
+    }
+
+    friend bool operator==(const ElementMask&, const ElementMask&) = default;
+
+    friend std::strong_ordering operator<=>(const ElementMask& a, const ElementMask& b) noexcept {
+        for (std::size_t i = Words; i-- > 0;) {
+            if (a.w[i] != b.w[i]) return a.w[i] <=> b.w[i];
+        }
+        return std::strong_ordering::equal;
+    }
+};
+
+inline constexpr std::size_t kMaxMaskWords = 8;
+
+// Smallest supported mask width, in 64-bit words, that covers element handles 1..numElements.
+constexpr std::size_t MaskWordsFor(std::size_t numElements) noexcept {
+    if (numElements <= 64) return 1;
+    if (numElements <= 128) return 2;
+    if (numElements <= 256) return 4;
+    return kMaxMaskWords;
+}
@@ -4,10 +4,13 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 #include <functional>
 #include <limits>
+#include <mutex>
 #include <optional>
 #include <ranges>
 #include <type_traits>
@@ -15,11 +18,16 @@
 #include <vector>
 
 #include "../Config.h"
+#include "../ModAPI.h"
 #include "../common/Helpers.h"
+#include "../common/FrameArena.h"
 #include "../common/PluginSerialization.h"
 #include "../hud/HUDTick.h"
 #include "../hud/InjectHUD.h"
 #include "ElementalStates.h"
+#include "GaugeCore.h"
+#include "GaugeTrace.h"
+#include "RegistrySchema.h"
 #include "erf_preeffect.h"
 
 using namespace ElementalGaugesDecay;
@@ -27,235 +35,117 @@ using Elem = ERF_ElementHandle;
 
 namespace Gauges {
     inline constexpr std::uint32_t kRecordID = FOURCC('G', 'A', 'U', 'V');
-    inline constexpr std::uint32_t kVersion = 4;
+    inline constexpr std::uint32_t kVersion = 5;
+    inline constexpr std::uint32_t kVersionFullArrays = 4;
     inline constexpr float increaseMult = 1.30f;
     inline constexpr float decreaseMult = 0.10f;
-    constexpr bool kReserveZero = true;
-
-    struct Entry {
-        std::vector<std::uint8_t> v;
-        std::vector<float> lastHitH;
-        std::vector<float> lastEvalH;
-        std::vector<float> blockUntilH;
-        std::vector<double> blockUntilRtS;
-
-        std::vector<double> reactCdRtS;
-        std::vector<float> reactCdH;
-        std::vector<std::uint8_t> inReaction;
-
-        std::vector<std::uint8_t> preActive;
-        std::vector<float> preIntensity;
-        std::vector<double> preExpireRtS;
-        std::vector<float> preExpireH;
-
-        std::vector<double> effMult;
-        bool effDirty = true;
-
-        bool sized = false;
-        std::uint64_t presentMask = 0;
-        std::vector<ERF_ElementHandle> presentList;
-        int sumAll = 0;
-        int sumMix = 0;
-        std::vector<std::uint16_t> posInList;
-    };
+}
 
-    using Map = ankerl::unordered_dense::map<RE::FormID, Entry>;
-    inline Map& state() noexcept {
-        static Map m;
-        if (m.bucket_count() == 0) m.reserve(512);
-        return m;
-    }
+namespace {
+    static std::vector<std::uint32_t> g_colorLUT;
+    constexpr const char* kFallbackReactionIcon = "ERF_ICON__erf_core__fallback";
 
-    inline std::size_t firstIndex() { return kReserveZero ? 1u : 0u; }
-    inline std::size_t idx(ERF_ElementHandle h) { return static_cast<std::size_t>(h == 0 ? 1 : h); }
-    inline std::size_t idxElem(ERF_ElementHandle h) { return static_cast<std::size_t>(h == 0 ? 1 : h); }
-    inline std::size_t idxReact(ERF_ReactionHandle r) { return static_cast<std::size_t>(r == 0 ? 1 : r); }
-    inline std::size_t idxPre(ERF_PreEffectHandle p) { return static_cast<std::size_t>(p == 0 ? 1 : p); }
-
-    inline void initEntryDenseIfNeeded(Entry& e) {
-        if (e.sized) return;
-        const auto& caps = ERF::API::Caps();
-
-        const std::size_t nE = static_cast<std::size_t>(caps.numElements) + 1;
-        const std::size_t nR = static_cast<std::size_t>(caps.numReactions) + 1;
-        const std::size_t nP = static_cast<std::size_t>(caps.numPreEffects) + 1;
-
-        e.v.assign(nE, 0);
-        e.lastHitH.assign(nE, 0.f);
-        e.lastEvalH.assign(nE, 0.f);
-        e.blockUntilH.assign(nE, 0.f);
-        e.blockUntilRtS.assign(nE, 0.0);
-        e.effMult.assign(nE, 1.0);
-
-        e.reactCdRtS.assign(nR, 0.0);
-        e.reactCdH.assign(nR, 0.f);
-        e.inReaction.assign(nR, 0u);
-
-        e.preActive.assign(nP, 0u);
-        e.preIntensity.assign(nP, 0.f);
-        e.preExpireRtS.assign(nP, 0.0);
-        e.preExpireH.assign(nP, 0.f);
-
-        e.effDirty = true;
-        e.sized = true;
-
-        e.presentMask = 0;
-        e.presentList.clear();
-        e.sumAll = 0;
-        e.sumMix = 0;
-        e.posInList.assign(nE, 0xFFFF);
-    }
+    // HUD scratch, UI thread only. TL_hudTotals is all zeros between icon picks.
+    thread_local FrameArena TL_hudArena;
+    thread_local std::vector<std::uint8_t> TL_hudTotals;
 
-    struct DecaySnapshot {
-        float ratePerHour;
-        float graceHours;
+    struct HudElem {
+        ERF_ElementHandle handle{};
+        std::uint8_t value{0};
+        std::uint32_t rgb{0xFFFFFF};
+        bool isolated{false};
     };
 
-    inline DecaySnapshot SnapshotDecay() {
-        const float ts = Timescale();
-        DecaySnapshot s{kRealDecayPerSec * 3600.0f / ts, (kGraceSec * ts) / 3600.0f};
-        return s;
-    }
-
-    inline ERF_ElementHandle handleFromIndex(std::size_t idx) { return static_cast<ERF_ElementHandle>(idx); }
-
-    inline void makePresent(Entry& e, std::size_t i) {
-        if (i < firstIndex()) return;
-        if (i >= e.posInList.size()) return;
-        if (e.posInList[i] != 0xFFFF) return;
-        const ERF_ElementHandle h = handleFromIndex(i);
+    // Direct-mapped memo of HUD icon picks. A pick only depends on which elements are present and on their share of
+    // the sum, so the key is the present handles (sorted) with each share rounded to a whole percent.
+    class HudIconCache {
+    public:
+        static constexpr std::size_t kMaxElems = 8;
+        static constexpr unsigned kBits = 10;
+
+        struct Key {
+            std::uint64_t hash{0};
+            std::uint8_t count{0};
+            std::array<ERF_ElementHandle, kMaxElems> elems{};
+            std::array<std::uint8_t, kMaxElems> pct{};
+            bool operator==(const Key&) const = default;
+        };
 
-        if (const auto bit = static_cast<unsigned>(h - 1); bit < 64) e.presentMask |= (UINT64_C(1) << bit);
-        e.posInList[i] = static_cast<std::uint16_t>(e.presentList.size());
-        e.presentList.push_back(h);
-    }
-    inline void dropPresent(Entry& e, std::size_t i) {
-        if (i < firstIndex()) return;
-        if (i >= e.posInList.size()) return;
-        auto pos = e.posInList[i];
-        if (pos == 0xFFFF) return;
-        const auto lastIdx = static_cast<std::uint16_t>(e.presentList.size() - 1);
-        const ERF_ElementHandle h = handleFromIndex(i);
-
-        if (const auto bit = static_cast<unsigned>(h - 1); bit < 64) e.presentMask &= ~(UINT64_C(1) << bit);
-        if (pos != lastIdx) {
-            const ERF_ElementHandle lastH = e.presentList[lastIdx];
-            e.presentList[pos] = lastH;
-            const std::size_t lastI = idx(lastH);
-            if (lastI < e.posInList.size()) e.posInList[lastI] = pos;
-        }
-        e.presentList.pop_back();
-        e.posInList[i] = 0xFFFF;
-    }
-    inline void onValChange(Entry& e, std::size_t i, int before, int after) {
-        if (i < firstIndex()) return;
-
-        const int delta = after - before;
-
-        e.sumAll += delta;
-        if (e.sumAll < 0) e.sumAll = 0;
-
-        if (delta != 0) {
-            const ERF_ElementHandle h = handleFromIndex(i);
-            if (h != 0) {
-                auto const& ER = ElementRegistry::get();
-                if (const ERF_ElementDesc* d = ER.get(h)) {
-                    if (!d->noMixInMixedMode) {
-                        e.sumMix += delta;
-                        if (e.sumMix < 0) e.sumMix = 0;
-                    }
-                } else {
-                    e.sumMix += delta;
-                    if (e.sumMix < 0) e.sumMix = 0;
+        static bool makeKey(std::span<const ERF_ElementHandle> present, std::span<const std::uint8_t> values, int sum,
+                            Key& out) {
+            if (present.size() > kMaxElems) return false;
+            out = Key{};
+            for (std::size_t k = 0; k < present.size(); ++k) {
+                const auto q = static_cast<std::uint8_t>((values[k] * 100 + sum / 2) / sum);
+                std::size_t at = out.count++;
+                for (; at > 0 && out.elems[at - 1] > present[k]; --at) {
+                    out.elems[at] = out.elems[at - 1];
+                    out.pct[at] = out.pct[at - 1];
                 }
+                out.elems[at] = present[k];
+                out.pct[at] = q;
+            }
+            std::uint64_t h = 0xCBF29CE484222325ull;
+            for (std::size_t k = 0; k < out.count; ++k) {
+                h = (h ^ ((std::uint64_t{out.elems[k]} << 8) | out.pct[k])) * 0x9E3779B97F4A7C15ull;
             }
+            out.hash = h;
+            return true;
         }
 
-        const bool was = (before > 0);
-        const bool is = (after > 0);
-        if (was == is) return;
-        if (is)
-            makePresent(e, i);
-        else
-            dropPresent(e, i);
-    }
-
-    inline void tickOne(Entry& e, std::size_t i, float nowH, const DecaySnapshot& snap) {
-        auto& val = e.v[i];
-        auto& eval = e.lastEvalH[i];
-        const float hit = e.lastHitH[i];
-
-        if (val == 0) {
-            eval = nowH;
-            return;
+        const char* const* find(const Key& k) {
+            if (_slots.empty()) return nullptr;
+            const auto& s = _slots[k.hash >> (64 - kBits)];
+            return s.key == k ? &s.icon : nullptr;
         }
 
-        const float rate = snap.ratePerHour;
-        if (rate <= 0.f) {
-            eval = nowH;
-            return;
+        void store(const Key& k, const char* icon) {
+            if (_slots.empty()) _slots.resize(std::size_t{1} << kBits);
+            auto& s = _slots[k.hash >> (64 - kBits)];
+            s.key = k;
+            s.icon = icon;
         }
 
-        const float graceEnd = hit + snap.graceHours;
-        if (nowH <= graceEnd) return;
-
-        const float startH = std::max(eval, graceEnd);
-        const float elapsedH = nowH - startH;
-        if (elapsedH <= 0.f) return;
-
-        const float decF = elapsedH * rate;
-        const auto decI = static_cast<int>(decF);
-        if (decI <= 0) return;
-
-        const auto before = static_cast<int>(val);
-        int next = before - decI;
-        if (next < 0) next = 0;
-        val = static_cast<std::uint8_t>(next);
-        if (next != before) onValChange(e, i, before, next);
-
-        const float rem = decF - static_cast<float>(decI);
-        eval = nowH - (rem / rate);
-    }
+    private:
+        struct Slot {
+            Key key;
+            const char* icon{nullptr};
+        };
+        std::vector<Slot> _slots;
+    };
 
-    inline void tickAll(Entry& e, float nowH, const DecaySnapshot& snap) {
-        const auto n = e.v.size();
-        for (std::size_t i = firstIndex(); i < n; ++i) {
-            tickOne(e, i, nowH, snap);
+    HudIconCache g_hudIcons;  // UI thread only, like the rest of the HUD scratch
+    std::atomic<std::uint64_t> g_hudIconHits{0};
+    std::atomic<std::uint64_t> g_hudIconMisses{0};
+
+    // Writes only the indices in `present`, picks, and zeroes them again, so a pick costs O(present) instead of a
+    // full-width clear.
+    const char* PickHudIcon(std::span<const ERF_ElementHandle> present, std::span<const std::uint8_t> values) {
+        int sum = 0;
+        for (auto v : values) sum += v;
+        if (sum <= 0) return nullptr;
+
+        HudIconCache::Key key;
+        const bool cacheable = HudIconCache::makeKey(present, values, sum, key);
+        if (cacheable) {
+            if (const auto* hit = g_hudIcons.find(key)) {
+                g_hudIconHits.fetch_add(1, std::memory_order_relaxed);
+                return *hit;
+            }
         }
-    }
-
-    inline void rebuildPresence(Entry& e) {
-        e.presentMask = 0;
-        e.presentList.clear();
-        e.sumAll = 0;
-        e.sumMix = 0;
-        e.posInList.assign(e.v.size(), 0xFFFF);
-
-        auto const& ER = ElementRegistry::get();
-
-        for (std::size_t i = firstIndex(); i < e.v.size(); ++i) {
-            const int v = e.v[i];
-            if (v > 0) {
-                e.sumAll += v;
+        g_hudIconMisses.fetch_add(1, std::memory_order_relaxed);
 
-                const ERF_ElementHandle h = handleFromIndex(i);
-                if (const ERF_ElementDesc* d = ER.get(h); !d || !d->noMixInMixedMode) {
-                    e.sumMix += v;
-                }
-
-                makePresent(e, i);
-            }
+        auto& totals = TL_hudTotals;
+        for (std::size_t k = 0; k < present.size(); ++k) {
+            totals[Gauges::idx(present[k])] = values[k];
         }
-    }
-}
+        const auto best = ReactionRegistry::get().pickBestFast(totals, present, sum, 1.0f / static_cast<float>(sum));
+        const char* icon = (best && best->icon) ? best->icon : kFallbackReactionIcon;
+        for (auto h : present) totals[Gauges::idx(h)] = 0;
 
-namespace {
-    thread_local std::vector<std::uint32_t> TL_vals32;
-    thread_local std::vector<std::uint32_t> TL_cols32;
-    thread_local std::vector<const char*> TL_accumIcons;
-    thread_local std::vector<ERF_ElementHandle> TL_elemsNZ;
-    static std::vector<std::uint32_t> g_colorLUT;
-    constexpr const char* kFallbackReactionIcon = "ERF_ICON__erf_core__fallback";
+        if (cacheable) g_hudIcons.store(key, icon);
+        return icon;
+    }
 
     inline double NowRealSeconds() {
         using clock = std::chrono::steady_clock;
@@ -263,630 +153,496 @@ namespace {
         return std::chrono::duration<double>(clock::now() - t0).count();
     }
 
-    inline int SumAll(const Gauges::Entry& e) {
-        int s = 0;
-        for (std::size_t i = Gauges::firstIndex(); i < e.v.size(); ++i) s += e.v[i];
-        return s;
-    }
-
-    inline void ApplyElementLocksForReaction(Gauges::Entry& e, const std::vector<ERF_ElementHandle>& elems,
-                                             float seconds) {
-        if (seconds <= 0.f) return;
-
-        const double nowRt = NowRealSeconds();
-        const double untilRt = nowRt + seconds;
-
-        for (ERF_ElementHandle h : elems) {
-            const std::size_t idx = Gauges::idx(h);
-            if (idx >= e.v.size()) continue;
-            e.blockUntilRtS[idx] = std::max(e.blockUntilRtS[idx], untilRt);
-        }
-    }
-
-    inline void SetReactionCooldown(Gauges::Entry& e, ERF_ReactionHandle rh, float cooldownSeconds) {
-        if (cooldownSeconds <= 0.f || rh == 0) return;
-
-        const std::size_t ri = Gauges::idxReact(rh);
-
-        const double untilRt = NowRealSeconds() + static_cast<double>(cooldownSeconds);
-        if (ri < e.reactCdRtS.size()) e.reactCdRtS[ri] = std::max(e.reactCdRtS[ri], untilRt);
+    std::span<const std::uint32_t> GetColorLUT() {
+        return std::span<const std::uint32_t>(g_colorLUT.data(), g_colorLUT.size());
     }
+}
 
-    bool TriggerReaction(RE::Actor* a, Gauges::Entry& e, ERF_ElementHandle elem) {
-        if (!a) {
-            return false;
-        }
-        if (e.sumAll <= 0) {
-            return false;
-        }
-
-        auto const& RR = ReactionRegistry::get();
-
-        int maxCount = ERF::GetConfig().maxReactionsPerTrigger.load(std::memory_order_relaxed);
-        if (maxCount < 1) {
-            maxCount = 1;
-        }
-
-        std::vector<ERF_PickBestInfo> picks;
-        picks.reserve(static_cast<std::size_t>(maxCount));
-
-        if (elem == 0) {
-            const int sum = e.sumMix;
-            if (sum <= 0) {
-                return false;
+namespace {
+    // v5 record layout, built in one buffer and written with a single WriteRecordData:
+    //   u32 actorCount, then per actor: u32 formID and three sparse sections (elements, reactions, pre-effects).
+    //   Each section is a u16 count followed by (varint index delta, u8 flags, payload) runs for the slots that
+    //   differ from their defaults. Real-time deadlines are stored as seconds remaining, since the real-time clock
+    //   restarts with the game; game-hour values stay absolute because the calendar is saved with the game.
+    namespace GaugeRecord {
+        enum ElemFlags : std::uint8_t { kElemValue = 1, kElemBlockH = 2, kElemBlockRt = 4 };
+        enum ReactFlags : std::uint8_t { kReactActive = 1, kReactCdH = 2, kReactCdRt = 4 };
+
+        struct Writer {
+            std::vector<std::uint8_t>& buf;
+
+            template <class T>
+            void pod(const T& v) {
+                const auto* p = reinterpret_cast<const std::uint8_t*>(&v);
+                buf.insert(buf.end(), p, p + sizeof(T));
             }
-
-            auto const& ER = ElementRegistry::get();
-
-            std::vector<std::uint8_t> totals(e.v.size(), 0);
-            std::vector<ERF_ElementHandle> presentMix;
-            presentMix.reserve(e.presentList.size());
-
-            for (ERF_ElementHandle h : e.presentList) {
-                if (const ERF_ElementDesc* d = ER.get(h); d && d->noMixInMixedMode) {
-                    continue;
+            void varint(std::uint32_t v) {
+                while (v >= 0x80) {
+                    buf.push_back(static_cast<std::uint8_t>(v | 0x80));
+                    v >>= 7;
                 }
+                buf.push_back(static_cast<std::uint8_t>(v));
+            }
+        };
 
-                const std::size_t idx = Gauges::idx(h);
-                if (idx >= e.v.size()) {
-                    continue;
+        struct Reader {
+            const std::uint8_t* p;
+            const std::uint8_t* end;
+            bool ok = true;
+
+            template <class T>
+            T pod() {
+                T v{};
+                if (static_cast<std::size_t>(end - p) < sizeof(T)) {
+                    ok = false;
+                    return v;
                 }
-
-                const std::uint8_t v = e.v[idx];
-                if (!v) {
-                    continue;
+                std::memcpy(&v, p, sizeof(T));
+                p += sizeof(T);
+                return v;
+            }
+            std::uint32_t varint() {
+                std::uint32_t v = 0;
+                for (int shift = 0; shift < 35; shift += 7) {
+                    if (p == end) break;
+                    const std::uint8_t b = *p++;
+                    v |= static_cast<std::uint32_t>(b & 0x7F) << shift;
+                    if ((b & 0x80) == 0) return v;
                 }
-
-                totals[idx] = v;
-                presentMix.push_back(h);
+                ok = false;
+                return 0;
             }
+        };
 
-            if (presentMix.empty()) {
+        inline float remainRt(double until, double nowRt) { return static_cast<float>(until - nowRt); }
+
+        // Writes the sparse sections of one entry; returns false (and writes nothing) when every slot is default.
+        bool writeEntry(Writer& w, RE::FormID id, const Gauges::Entry& e, double nowRt, float nowH) {
+            const std::size_t mark = w.buf.size();
+            w.pod(id);
+
+            const auto section = [&](std::size_t first, std::size_t n, auto&& flagsOf, auto&& payload) {
+                const std::size_t countAt = w.buf.size();
+                std::uint16_t count = 0;
+                w.pod(count);
+                std::size_t prev = 0;
+                for (std::size_t i = first; i < n; ++i) {
+                    const std::uint8_t f = flagsOf(i);
+                    if (f == 0) continue;
+                    w.varint(static_cast<std::uint32_t>(i - prev));
+                    w.pod(f);
+                    payload(i, f);
+                    prev = i;
+                    ++count;
+                }
+                std::memcpy(w.buf.data() + countAt, &count, sizeof(count));
+                return count;
+            };
+
+            const auto first = Gauges::firstIndex();
+            std::uint32_t slots = 0;
+
+            slots += section(
+                first, e.v.size(),
+                [&](std::size_t i) {
+                    std::uint8_t f = 0;
+                    if (e.v[i] != 0) f |= kElemValue;
+                    if (e.blockUntilH[i] > nowH) f |= kElemBlockH;
+                    if (e.blockUntilRtS[i] > nowRt) f |= kElemBlockRt;
+                    return f;
+                },
+                [&](std::size_t i, std::uint8_t f) {
+                    if (f & kElemValue) {
+                        w.pod(e.v[i]);
+                        w.pod(e.lastHitH[i]);
+                        w.pod(e.lastEvalH[i]);
+                    }
+                    if (f & kElemBlockH) w.pod(e.blockUntilH[i]);
+                    if (f & kElemBlockRt) w.pod(remainRt(e.blockUntilRtS[i], nowRt));
+                });
+
+            slots += section(
+                first, e.reactCdRtS.size(),
+                [&](std::size_t i) {
+                    std::uint8_t f = 0;
+                    if (e.inReaction[i] != 0) f |= kReactActive;
+                    if (e.reactCdH[i] > nowH) f |= kReactCdH;
+                    if (e.reactCdRtS[i] > nowRt) f |= kReactCdRt;
+                    return f;
+                },
+                [&](std::size_t i, std::uint8_t f) {
+                    if (f & kReactCdH) w.pod(e.reactCdH[i]);
+                    if (f & kReactCdRt) w.pod(remainRt(e.reactCdRtS[i], nowRt));
+                });
+
+            slots += section(
+                first, e.preActive.size(), [&](std::size_t i) { return e.preActive[i]; },
+                [&](std::size_t i, std::uint8_t) {
+                    w.pod(e.preIntensity[i]);
+                    w.pod(e.preExpireH[i]);
+                    w.pod(remainRt(e.preExpireRtS[i], nowRt));
+                });
+
+            if (slots == 0) {
+                w.buf.resize(mark);
                 return false;
             }
+            return true;
+        }
 
-            const float invSum = 1.0f / static_cast<float>(sum);
-
-            RR.pickBestFastMulti(totals, std::span<const ERF_ElementHandle>(presentMix.data(), presentMix.size()), sum,
-                                 invSum, maxCount, picks);
-            if (picks.empty()) {
-                const float nowH = NowHours();
-                auto const& ER2 = ElementRegistry::get();
-                bool clearedAny = false;
-
-                for (std::size_t i = Gauges::firstIndex(); i < e.v.size(); ++i) {
-                    const int before = e.v[i];
-                    if (!before) {
-                        continue;
-                    }
-
-                    const ERF_ElementHandle h2 = Gauges::handleFromIndex(i);
-
-                    if (const ERF_ElementDesc* d2 = ER2.get(h2); d2 && d2->noMixInMixedMode) {
-                        continue;
+        // Slot indices on disk are handles from the save's registries; each is remapped to the current handle, and
+        // slots whose element, reaction or pre-effect is gone are parsed and dropped.
+        bool readEntry(Reader& r, Gauges::Entry* e, double nowRt) {
+            using RegistrySchema::Kind;
+            const auto& remap = RegistrySchema::Active();
+            const auto section = [&](Kind kind, std::size_t n, auto&& payload) {
+                const auto count = r.pod<std::uint16_t>();
+                std::size_t old = 0;
+                for (std::uint16_t k = 0; k < count && r.ok; ++k) {
+                    old += r.varint();
+                    const auto f = r.pod<std::uint8_t>();
+                    const std::size_t i = remap.toNew(kind, old);
+                    payload(i != 0 && i < n ? e : nullptr, i, f);
+                }
+            };
+
+            section(Kind::kElement, e ? e->v.size() : 0, [&](Gauges::Entry* d, std::size_t i, std::uint8_t f) {
+                if (f & kElemValue) {
+                    const auto v = r.pod<std::uint8_t>();
+                    const auto hit = r.pod<float>();
+                    const auto eval = r.pod<float>();
+                    if (d) {
+                        d->v[i] = v;
+                        d->lastHitH[i] = hit;
+                        d->lastEvalH[i] = eval;
                     }
-
-                    e.v[i] = 0;
-                    e.lastHitH[i] = nowH;
-                    e.lastEvalH[i] = nowH;
-
-                    onValChange(e, i, before, 0);
-                    clearedAny = true;
                 }
-
-                return clearedAny;
-            }
-
-            const float nowH = NowHours();
-
-            bool clearedAll = false;
-            bool any = false;
-
-            for (const auto& info : picks) {
-                const ERF_ReactionHandle rh = info.handle;
-                if (!rh) {
-                    continue;
+                if (f & kElemBlockH) {
+                    const auto h = r.pod<float>();
+                    if (d) d->blockUntilH[i] = h;
                 }
-
-                const ERF_ReactionDesc* r = RR.get(rh);
-                if (!r) {
-                    continue;
+                if (f & kElemBlockRt) {
+                    const auto rem = r.pod<float>();
+                    if (d) d->blockUntilRtS[i] = nowRt + rem;
                 }
+            });
 
-                if (!clearedAll) {
-                    for (std::size_t i = Gauges::firstIndex(); i < e.v.size(); ++i) {
-                        const int before = e.v[i];
-                        if (!before) {
-                            continue;
-                        }
-
-                        const ERF_ElementHandle h = Gauges::handleFromIndex(i);
-
-                        if (const ERF_ElementDesc* d = ER.get(h); d && d->noMixInMixedMode) {
-                            continue;
-                        }
-
-                        e.v[i] = 0;
-                        e.lastHitH[i] = nowH;
-                        e.lastEvalH[i] = nowH;
-
-                        onValChange(e, i, before, 0);
-                    }
-
-                    clearedAll = true;
+            section(Kind::kReaction, e ? e->reactCdRtS.size() : 0, [&](Gauges::Entry* d, std::size_t i, std::uint8_t f) {
+                if (d && (f & kReactActive)) d->inReaction[i] = 1;
+                if (f & kReactCdH) {
+                    const auto h = r.pod<float>();
+                    if (d) d->reactCdH[i] = h;
                 }
-
-                ApplyElementLocksForReaction(e, r->elements, r->elementLockoutSeconds);
-
-                SetReactionCooldown(e, rh, r->cooldownSeconds);
-
-                const float durS =
-                    (r->elementLockoutSeconds > 0.f) ? r->elementLockoutSeconds : std::max(0.5f, r->cooldownSeconds);
-
-                InjectHUD::BeginReaction(a, rh, durS);
-
-                if (r->cb) {
-                    if (auto* tasks = SKSE::GetTaskInterface()) {
-                        RE::ActorHandle hActor = a->CreateRefHandle();
-                        auto cb = r->cb;
-                        void* user = r->user;
-                        tasks->AddTask([hActor, cb, user]() {
-                            if (auto actorNi = hActor.get()) {
-                                if (auto* target = actorNi.get()) {
-                                    ERF_ReactionContext ctx{};
-                                    ctx.target = target;
-                                    cb(ctx, user);
-                                }
-                            }
-                        });
-                    } else {
-                        ERF_ReactionContext ctx{};
-                        ctx.target = a;
-                        r->cb(ctx, r->user);
-                    }
+                if (f & kReactCdRt) {
+                    const auto rem = r.pod<float>();
+                    if (d) d->reactCdRtS[i] = nowRt + rem;
                 }
+            });
 
-                any = true;
-            }
-
-            return any;
-        }
-
-        const std::size_t idx = Gauges::idx(elem);
-        const int v = (idx < e.v.size()) ? static_cast<int>(e.v[idx]) : 0;
-        if (v <= 0) {
-            return false;
-        }
-
-        std::vector<std::uint8_t> totals(e.v.size(), 0);
-        totals[idx] = static_cast<std::uint8_t>(v);
-
-        std::vector<ERF_ElementHandle> present;
-        present.reserve(1);
-        present.push_back(elem);
-
-        const int sum = v;
-        const float invSum = 1.0f / static_cast<float>(sum);
-
-        RR.pickBestFastMulti(totals, std::span<const ERF_ElementHandle>(present.data(), present.size()), sum, invSum,
-                             maxCount, picks);
-        const float nowH = NowHours();
-        const int beforeVal = v;
-
-        if (picks.empty()) {
-            e.v[idx] = 0;
-            e.lastHitH[idx] = nowH;
-            e.lastEvalH[idx] = nowH;
-            Gauges::onValChange(e, idx, beforeVal, 0);
-            return true;
-        }
-
-        bool clearedElem = false;
-        bool any = false;
-
-        for (const auto& info : picks) {
-            const ERF_ReactionHandle rh = info.handle;
-            if (!rh) {
-                continue;
-            }
-
-            const ERF_ReactionDesc* r = RR.get(rh);
-            if (!r) {
-                continue;
-            }
-
-            if (!clearedElem) {
-                e.v[idx] = 0;
-                e.lastHitH[idx] = nowH;
-                e.lastEvalH[idx] = nowH;
-                Gauges::onValChange(e, idx, beforeVal, 0);
-                clearedElem = true;
-            }
-
-            ApplyElementLocksForReaction(e, r->elements, r->elementLockoutSeconds);
-
-            SetReactionCooldown(e, rh, r->cooldownSeconds);
-
-            const float durS =
-                (r->elementLockoutSeconds > 0.f) ? r->elementLockoutSeconds : std::max(0.5f, r->cooldownSeconds);
-
-            InjectHUD::BeginReaction(a, rh, durS);
-
-            if (r->cb) {
-                if (auto* tasks = SKSE::GetTaskInterface()) {
-                    RE::ActorHandle h = a->CreateRefHandle();
-                    auto cb = r->cb;
-                    void* user = r->user;
-                    tasks->AddTask([h, cb, user]() {
-                        if (auto actorNi = h.get()) {
-                            if (auto* target = actorNi.get()) {
-                                ERF_ReactionContext ctx{};
-                                ctx.target = target;
-                                cb(ctx, user);
-                            }
-                        }
-                    });
-                } else {
-                    ERF_ReactionContext ctx{};
-                    ctx.target = a;
-                    r->cb(ctx, r->user);
-                }
-            }
+            section(Kind::kPreEffect, e ? e->preActive.size() : 0, [&](Gauges::Entry* d, std::size_t i, std::uint8_t f) {
+                const auto intensity = r.pod<float>();
+                const auto expH = r.pod<float>();
+                const auto rem = r.pod<float>();
+                if (!d) return;
+                d->preActive[i] = f;
+                d->preIntensity[i] = intensity;
+                d->preExpireH[i] = expH;
+                d->preExpireRtS[i] = rem > 0.f ? nowRt + rem : 0.0;
+            });
 
-            any = true;
+            return r.ok;
         }
-
-        return any;
     }
 
-    bool MaybeTriggerPreEffectsFor(RE::Actor* a, Gauges::Entry& e, ERF_ElementHandle elem, std::uint8_t gaugeNow) {
-        if (!a || elem == 0) return false;
-
-        const auto list = PreEffectRegistry::get().listByElement(elem);
-        if (list.empty()) return false;
+    // Encoded by the dry-run pass at the start of the save callback, after compaction; the write pass only copies
+    // these bytes out, so what lands in the co-save is one consistent picture of the store.
+    struct SaveSnapshot {
+        std::vector<std::uint8_t> bytes;
+        std::uint32_t count = 0;
+        bool ready = false;
+    };
+    SaveSnapshot g_saveSnapshot;
 
+    void CaptureSaveSnapshot() {
         const double nowRt = NowRealSeconds();
         const float nowH = NowHours();
+        Gauges::compact(nowRt, nowH, Gauges::SnapshotDecay());
 
-        bool any = false;
-
-        for (auto ph : list) {
-            const auto* pd = PreEffectRegistry::get().get(ph);
-            if (!pd || pd->element != elem) continue;
-
-            const std::size_t pi = Gauges::idxPre(ph);
-            if (pi >= e.preActive.size()) continue;
-
-            if (const bool above = (gaugeNow >= pd->minGauge); !above) {
-                if (e.preActive[pi]) {
-                    e.preActive[pi] = 0u;
-                    e.preIntensity[pi] = 0.f;
-                    e.preExpireRtS[pi] = 0.0;
-                    e.preExpireH[pi] = 0.f;
-
-                    if (pd->cb) {
-                        if (auto* tasks = SKSE::GetTaskInterface()) {
-                            RE::ActorHandle h = a->CreateRefHandle();
-                            auto cb = pd->cb;
-                            auto user = pd->user;
-                            const auto passElem = elem;
-                            const auto passGauge = gaugeNow;
-                            tasks->AddTask([h, cb, user, passElem, passGauge]() {
-                                if (auto actorPtr = h.get().get()) {
-                                    cb(actorPtr, passElem, passGauge, 0.0f, user);
-                                }
-                            });
-                        } else {
-                            pd->cb(a, elem, gaugeNow, 0.0f, pd->user);
-                        }
-                    }
-                    any = true;
-                }
-                continue;
-            }
-
-            float intensity = pd->baseIntensity + pd->scalePerPoint * static_cast<float>(gaugeNow - pd->minGauge);
-            if (intensity < pd->minIntensity) intensity = pd->minIntensity;
-            if (intensity > pd->maxIntensity) intensity = pd->maxIntensity;
-
-            bool needApply = false;
-
-            if (!e.preActive[pi]) {
-                needApply = true;
-            } else {
-                if (const float last = e.preIntensity[pi]; std::fabs(last - intensity) > 1e-3f) {
-                    needApply = true;
-                }
-
-                if (!needApply && pd->durationSeconds > 0.0f) {
-                    constexpr double marginRt = 0.20;
-                    constexpr float marginH = 0.20f / 3600.0f;
-                    if (pd->durationIsRealTime) {
-                        if (nowRt + marginRt >= e.preExpireRtS[pi]) needApply = true;
-                    } else {
-                        if (nowH + marginH >= e.preExpireH[pi]) needApply = true;
-                    }
-                }
-            }
-
-            if (!needApply) continue;
-
-            if (pd->cb) {
-                if (auto* tasks = SKSE::GetTaskInterface()) {
-                    RE::ActorHandle h = a->CreateRefHandle();
-                    auto cb = pd->cb;
-                    auto user = pd->user;
-                    const auto passElem = elem;
-                    const auto passGauge = gaugeNow;
-                    const auto passIntensity = intensity;
-                    tasks->AddTask([h, cb, user, passElem, passGauge, passIntensity]() {
-                        if (auto actorPtr = h.get().get()) {
-                            cb(actorPtr, passElem, passGauge, passIntensity, user);
-                        }
-                    });
-                } else {
-                    pd->cb(a, elem, gaugeNow, intensity, pd->user);
-                }
-            }
-
-            e.preActive[pi] = 1u;
-            e.preIntensity[pi] = intensity;
+        const auto& m = Gauges::state();
+        auto& snap = g_saveSnapshot;
+        snap.bytes.clear();
+        snap.bytes.reserve(64 + m.size() * 32);
 
-            if (pd->durationSeconds > 0.0f) {
-                if (pd->durationIsRealTime) {
-                    const double untilRt = nowRt + static_cast<double>(pd->durationSeconds);
-                    e.preExpireRtS[pi] = std::max(e.preExpireRtS[pi], untilRt);
-                } else {
-                    const float untilH = nowH + static_cast<float>(pd->durationSeconds / 3600.0);
-                    e.preExpireH[pi] = std::max(e.preExpireH[pi], untilH);
-                }
-            }
+        GaugeRecord::Writer w{snap.bytes};
+        w.pod(std::uint32_t{0});
 
-            any = true;
+        snap.count = 0;
+        for (const auto& [id, e] : m) {
+            if (GaugeRecord::writeEntry(w, id, e, nowRt, nowH)) ++snap.count;
         }
-
-        return any;
+        std::memcpy(snap.bytes.data(), &snap.count, sizeof(snap.count));
+        snap.ready = true;
     }
 
-    inline void RecomputeEffMultipliers(RE::Actor* a, Gauges::Entry& e) {
-        const auto begin = Gauges::firstIndex();
-        const auto n = e.v.size();
-
-        std::fill(e.effMult.begin() + begin, e.effMult.begin() + n, 1.0);
-
-        if (!a) {
-            e.effDirty = false;
-            return;
-        }
-
-        for (std::size_t i = begin; i < n; ++i) {
-            const auto elem = static_cast<ERF_ElementHandle>(i);
-            const double m = ElementalStates::GetGaugeMultiplierFor(a, elem);
-            e.effMult[i] = m;
+    bool Save(SKSE::SerializationInterface* ser, bool dryRun) {
+        auto& snap = g_saveSnapshot;
+        if (dryRun) {
+            CaptureSaveSnapshot();
+            return snap.count != 0;
         }
 
-        e.effDirty = false;
+        if (!snap.ready) CaptureSaveSnapshot();
+        snap.ready = false;
+        return ser->WriteRecordData(snap.bytes.data(), static_cast<std::uint32_t>(snap.bytes.size()));
     }
 
-    std::span<const std::uint32_t> GetColorLUT() {
-        return std::span<const std::uint32_t>(g_colorLUT.data(), g_colorLUT.size());
-    }
-}
+    bool LoadV5(SKSE::SerializationInterface* ser, std::uint32_t length) {
+        static std::vector<std::uint8_t> buf;
+        buf.resize(length);
+        if (length != 0 && ser->ReadRecordData(buf.data(), length) != length) return false;
 
-namespace {
-    bool Save(SKSE::SerializationInterface* ser, bool dryRun) {
-        const auto& m = Gauges::state();
-        if (dryRun) {
-            return !m.empty();
-        }
+        GaugeRecord::Reader r{buf.data(), buf.data() + buf.size()};
+        const auto count = r.pod<std::uint32_t>();
+
+        const double nowRt = NowRealSeconds();
+        const auto snap = Gauges::SnapshotDecay();
+        for (std::uint32_t i = 0; i < count && r.ok; ++i) {
+            const auto oldID = r.pod<RE::FormID>();
+            RE::FormID newID{};
+            if (!r.ok) break;
+            if (!ser->ResolveFormID(oldID, newID)) {
+                if (!GaugeRecord::readEntry(r, nullptr, nowRt)) break;
+                continue;
+            }
 
-        if (const auto count = static_cast<std::uint32_t>(m.size()); !ser->WriteRecordData(&count, sizeof(count)))
-            return false;
+            auto [it, ins] = Gauges::acquire(newID);
+            auto& e = it->second;
+            if (!GaugeRecord::readEntry(r, &e, nowRt)) break;
 
-        auto writeVecU8 = [&](const std::vector<std::uint8_t>& v) {
-            const auto n = static_cast<std::uint32_t>(v.size());
-            return ser->WriteRecordData(&n, sizeof(n)) && (n == 0 || ser->WriteRecordData(v.data(), n * sizeof(v[0])));
-        };
-        auto writeVecF = [&](const std::vector<float>& v) {
-            const auto n = static_cast<std::uint32_t>(v.size());
-            return ser->WriteRecordData(&n, sizeof(n)) && (n == 0 || ser->WriteRecordData(v.data(), n * sizeof(v[0])));
-        };
-        auto writeVecD = [&](const std::vector<double>& v) {
-            const auto n = static_cast<std::uint32_t>(v.size());
-            return ser->WriteRecordData(&n, sizeof(n)) && (n == 0 || ser->WriteRecordData(v.data(), n * sizeof(v[0])));
-        };
+            e.effDirty = true;
 
-        for (const auto& [id, e] : m) {
-            if (!ser->WriteRecordData(&id, sizeof(id))) return false;
-
-            if (!writeVecU8(e.v)) return false;
-            if (!writeVecF(e.lastHitH)) return false;
-            if (!writeVecF(e.lastEvalH)) return false;
-            if (!writeVecF(e.blockUntilH)) return false;
-            if (!writeVecD(e.blockUntilRtS)) return false;
-
-            if (!writeVecD(e.reactCdRtS)) return false;
-            if (!writeVecF(e.reactCdH)) return false;
-            if (!writeVecU8(e.inReaction)) return false;
-
-            if (!writeVecU8(e.preActive)) return false;
-            if (!writeVecF(e.preIntensity)) return false;
-            if (!writeVecD(e.preExpireRtS)) return false;
-            if (!writeVecF(e.preExpireH)) return false;
+            Gauges::rebuildPresence(e);
+            Gauges::scheduleLoadedHolds(e, newID);
+            Gauges::queueDrainWake(e, newID, snap);
         }
-        return true;
+        return r.ok;
     }
 
-    bool Load(SKSE::SerializationInterface* ser, std::uint32_t version, std::uint32_t) {
-        if (version != Gauges::kVersion) return false;
-
-        auto& m = Gauges::state();
-        m.clear();
+    bool LoadV4(SKSE::SerializationInterface* ser) {
 
         std::uint32_t count{};
         if (!ser->ReadRecordData(&count, sizeof(count))) return false;
 
-        auto readVecU8 = [&](std::vector<std::uint8_t>& v) {
-            std::uint32_t n{};
-            if (!ser->ReadRecordData(&n, sizeof(n))) return false;
-            v.resize(n);
-            return n == 0 || ser->ReadRecordData(v.data(), n * sizeof(v[0]));
-        };
-        auto readVecF = [&](std::vector<float>& v) {
-            std::uint32_t n{};
-            if (!ser->ReadRecordData(&n, sizeof(n))) return false;
-            v.resize(n);
-            return n == 0 || ser->ReadRecordData(v.data(), n * sizeof(v[0]));
+        struct Scratch {
+            std::vector<std::uint8_t> v, inReaction, preActive;
+            std::vector<float> lastHitH, lastEvalH, blockUntilH, reactCdH, preIntensity, preExpireH;
+            std::vector<double> blockUntilRtS, reactCdRtS, preExpireRtS;
         };
-        auto readVecD = [&](std::vector<double>& v) {
+        static Scratch tmp;
+
+        auto readVec = [&]<class T>(std::vector<T>& v) {
             std::uint32_t n{};
             if (!ser->ReadRecordData(&n, sizeof(n))) return false;
             v.resize(n);
-            return n == 0 || ser->ReadRecordData(v.data(), n * sizeof(v[0]));
-        };
-
-        const auto& caps = ERF::API::Caps();
-        const std::size_t nE = static_cast<std::size_t>(caps.numElements) + 1;
-        const std::size_t nR = static_cast<std::size_t>(caps.numReactions) + 1;
-        const std::size_t nP = static_cast<std::size_t>(caps.numPreEffects) + 1;
-
-        auto padU8 = [&](std::vector<std::uint8_t>& v, std::size_t need) {
-            if (v.size() < need) v.resize(need, 0u);
+            return n == 0 || ser->ReadRecordData(v.data(), n * sizeof(T));
         };
-        auto padF = [&](std::vector<float>& v, std::size_t need) {
-            if (v.size() < need) v.resize(need, 0.f);
+        auto readAll = [&]() {
+            return readVec(tmp.v) && readVec(tmp.lastHitH) && readVec(tmp.lastEvalH) && readVec(tmp.blockUntilH) &&
+                   readVec(tmp.blockUntilRtS) && readVec(tmp.reactCdRtS) && readVec(tmp.reactCdH) &&
+                   readVec(tmp.inReaction) && readVec(tmp.preActive) && readVec(tmp.preIntensity) &&
+                   readVec(tmp.preExpireRtS) && readVec(tmp.preExpireH);
         };
-        auto padD = [&](std::vector<double>& v, std::size_t need) {
-            if (v.size() < need) v.resize(need, 0.0);
+        using RegistrySchema::Kind;
+        const auto& remap = RegistrySchema::Active();
+        auto copyInto = [&]<class T>(Kind kind, std::span<T> dst, const std::vector<T>& src) {
+            remap.gather<T>(kind, dst, std::span<const T>(src));
         };
 
+        const auto snap = Gauges::SnapshotDecay();
         for (std::uint32_t i = 0; i < count; ++i) {
             RE::FormID oldID{};
             RE::FormID newID{};
             if (!ser->ReadRecordData(&oldID, sizeof(oldID))) return false;
+            if (!readAll()) return false;
+            if (!ser->ResolveFormID(oldID, newID)) continue;
 
-            if (!ser->ResolveFormID(oldID, newID)) {
-                std::vector<std::uint8_t> u8;
-                std::vector<float> f;
-                std::vector<double> d;
-                if (!readVecU8(u8)) return false;
-                if (!readVecF(f)) return false;
-                if (!readVecF(f)) return false;
-                if (!readVecF(f)) return false;
-                if (!readVecD(d)) return false;
-
-                if (!readVecD(d)) return false;
-                if (!readVecF(f)) return false;
-                if (!readVecU8(u8)) return false;
-
-                if (!readVecU8(u8)) return false;
-                if (!readVecF(f)) return false;
-                if (!readVecD(d)) return false;
-                if (!readVecF(f)) return false;
-                continue;
-            }
-
-            Gauges::Entry e{};
-
-            if (!readVecU8(e.v)) return false;
-            if (!readVecF(e.lastHitH)) return false;
-            if (!readVecF(e.lastEvalH)) return false;
-            if (!readVecF(e.blockUntilH)) return false;
-            if (!readVecD(e.blockUntilRtS)) return false;
-
-            if (!readVecD(e.reactCdRtS)) return false;
-            if (!readVecF(e.reactCdH)) return false;
-            if (!readVecU8(e.inReaction)) return false;
+            auto [it, ins] = Gauges::acquire(newID);
+            auto& e = it->second;
 
-            if (!readVecU8(e.preActive)) return false;
-            if (!readVecF(e.preIntensity)) return false;
-            if (!readVecD(e.preExpireRtS)) return false;
-            if (!readVecF(e.preExpireH)) return false;
+            copyInto(Kind::kElement, e.v, tmp.v);
+            copyInto(Kind::kElement, e.lastHitH, tmp.lastHitH);
+            copyInto(Kind::kElement, e.lastEvalH, tmp.lastEvalH);
+            copyInto(Kind::kElement, e.blockUntilH, tmp.blockUntilH);
+            copyInto(Kind::kElement, e.blockUntilRtS, tmp.blockUntilRtS);
 
-            padU8(e.v, nE);
-            padF(e.lastHitH, nE);
-            padF(e.lastEvalH, nE);
-            padF(e.blockUntilH, nE);
-            padD(e.blockUntilRtS, nE);
+            copyInto(Kind::kReaction, e.reactCdRtS, tmp.reactCdRtS);
+            copyInto(Kind::kReaction, e.reactCdH, tmp.reactCdH);
+            copyInto(Kind::kReaction, e.inReaction, tmp.inReaction);
 
-            padD(e.reactCdRtS, nR);
-            padF(e.reactCdH, nR);
-            padU8(e.inReaction, nR);
+            copyInto(Kind::kPreEffect, e.preActive, tmp.preActive);
+            copyInto(Kind::kPreEffect, e.preIntensity, tmp.preIntensity);
+            copyInto(Kind::kPreEffect, e.preExpireRtS, tmp.preExpireRtS);
+            copyInto(Kind::kPreEffect, e.preExpireH, tmp.preExpireH);
 
-            padU8(e.preActive, nP);
-            padF(e.preIntensity, nP);
-            padD(e.preExpireRtS, nP);
-            padF(e.preExpireH, nP);
-
-            e.effMult.assign(nE, 1.0);
             e.effDirty = true;
-            e.sized = true;
 
             Gauges::rebuildPresence(e);
-
-            auto [it, ins] = m.try_emplace(newID, std::move(e));
-            if (!ins) it->second = std::move(e);
+            Gauges::scheduleLoadedHolds(e, newID);
+            Gauges::queueDrainWake(e, newID, snap);
         }
         return true;
     }
 
-    void Revert() { Gauges::state().clear(); }
-}
+    bool Load(SKSE::SerializationInterface* ser, std::uint32_t version, std::uint32_t length) {
+        if (version != Gauges::kVersion && version != Gauges::kVersionFullArrays) return false;
 
-void ElementalGauges::Add(RE::Actor* a, ERF_ElementHandle elem, int delta) {
-    if (!a || delta <= 0) return;
+        Gauges::clearAll();
+        return version == Gauges::kVersion ? LoadV5(ser, length) : LoadV4(ser);
+    }
 
-    auto& M = Gauges::state();
-    auto [__it, __inserted] = M.try_emplace(a->GetFormID());
-    auto& e = __it->second;
-    if (__inserted) Gauges::initEntryDenseIfNeeded(e);
+    void Revert() { Gauges::clearAll(); }
+}
 
-    const auto i = Gauges::idx(elem);
-    const float nowH = NowHours();
-    const double nowRt = NowRealSeconds();
+namespace {
+    // State changes arrive on API threads; the gauge map belongs to the thread that applies hits, so the actors
+    // whose multipliers moved are parked here and marked dirty from that side.
+    std::mutex g_staleLock;
+    std::vector<RE::FormID> g_stale;
+    std::atomic_bool g_anyStale{false};
 
-    const auto snap = Gauges::SnapshotDecay();
-    Gauges::tickAll(e, nowH, snap);
+    void ApplyStaleMultipliers() {
+        if (!g_anyStale.load(std::memory_order_acquire)) return;
 
-    if (nowH < e.blockUntilH[i] || nowRt < e.blockUntilRtS[i]) {
-        return;
-    }
-    if (e.effDirty) {
-        RecomputeEffMultipliers(a, e);
+        thread_local std::vector<RE::FormID> ids;
+        {
+            std::scoped_lock lk(g_staleLock);
+            g_anyStale.store(false, std::memory_order_relaxed);
+            ids.swap(g_stale);
+        }
+        auto& m = Gauges::state();
+        for (const auto id : ids) {
+            if (const auto it = m.find(id); it != m.end()) it->second.effDirty = true;
+        }
+        ids.clear();
     }
 
-    const int before = e.v[i];
-    const float mult = (a->IsPlayerRef() ? ERF::GetConfig().playerMult.load(std::memory_order_relaxed)
-                                         : ERF::GetConfig().npcMult.load(std::memory_order_relaxed));
-    const double scaled = std::round(static_cast<double>(delta) * mult * e.effMult[i]);
-    const int adj = (scaled <= 0.0) ? 0 : static_cast<int>(scaled);
-    const int afterI = std::clamp(before + adj, 0, 100);
+    // The shared gauge core runs against these. Events and tasks only ever name the actor of the batch being
+    // applied, so that one is handed over directly instead of going back through the form table.
+    RE::Actor* g_batchActor = nullptr;
+    Gauges::Tuning g_tuning;
 
-    const int sumBeforeMix = e.sumMix;
-    e.v[i] = static_cast<std::uint8_t>(afterI);
-    e.lastHitH[i] = nowH;
-    e.lastEvalH[i] = nowH;
-    onValChange(e, i, before, afterI);
+    RE::Actor* ActorFor(RE::FormID id) {
+        if (g_batchActor && g_batchActor->GetFormID() == id) return g_batchActor;
+        return RE::TESForm::LookupByID<RE::Actor>(id);
+    }
 
-    if (ERF::GetConfig().hudEnabled.load(std::memory_order_relaxed)) {
-        HUD::StartHUDTick();
+    void RefreshTuning() {
+        const auto& cfg = ERF::GetConfig();
+        g_tuning.isSingle = cfg.isSingle.load(std::memory_order_relaxed);
+        g_tuning.maxReactionsPerTrigger = cfg.maxReactionsPerTrigger.load(std::memory_order_relaxed);
+        g_tuning.playerMult = cfg.playerMult.load(std::memory_order_relaxed);
+        g_tuning.npcMult = cfg.npcMult.load(std::memory_order_relaxed);
     }
 
-    const auto& ER = ElementRegistry::get();
-    const ERF_ElementDesc* d = ER.get(elem);
-    const bool isIsolatedInMixed = d && d->noMixInMixedMode;
+    class GameClock final : public Gauges::Clock {
+    public:
+        double nowRt() const override { return NowRealSeconds(); }
+        float nowH() const override { return NowHours(); }
+        float timescale() const override { return Timescale(); }
+    };
 
-    if (const bool singleMode = ERF::GetConfig().isSingle.load(std::memory_order_relaxed);
-        singleMode || isIsolatedInMixed) {
-        if (before < 100 && afterI >= 100) {
-            TriggerReaction(a, e, elem);
+    class GameActors final : public Gauges::Actors {
+    public:
+        bool isPlayer(RE::FormID id) const override {
+            const auto* player = RE::PlayerCharacter::GetSingleton();
+            return player && player->GetFormID() == id;
         }
-    } else {
-        if (sumBeforeMix < 100 && e.sumMix >= 100) {
-            TriggerReaction(a, e, 0);
+        bool isGone(RE::FormID id) const override {
+            const auto* a = RE::TESForm::LookupByID<RE::Actor>(id);
+            return !a || a->IsDead();
+        }
+        void gaugeMultipliers(RE::FormID id, std::span<double> out) const override {
+            ElementalStates::FillGaugeMultipliers(id, out);
+        }
+    };
+
+    class GameTasks final : public Gauges::Tasks {
+    public:
+        void reaction(RE::FormID id, ERF_ReactionCallback cb, void* user) override {
+            Post(ActorFor(id), [cb, user](RE::Actor* target) {
+                ERF_ReactionContext ctx{};
+                ctx.target = target;
+                cb(ctx, user);
+            });
+        }
+        void preEffect(RE::FormID id, ERF_PreEffectDesc::Callback cb, ERF_ElementHandle elem, std::uint8_t gauge,
+                       float intensity, void* user) override {
+            Post(ActorFor(id),
+                 [cb, elem, gauge, intensity, user](RE::Actor* target) { cb(target, elem, gauge, intensity, user); });
+        }
+
+    private:
+        // Runs on the game thread with the actor resolved again through its handle; inline when there is no queue.
+        template <class F>
+        static void Post(RE::Actor* a, F fn) {
+            if (!a) return;
+            auto* tasks = SKSE::GetTaskInterface();
+            if (!tasks) {
+                fn(a);
+                return;
+            }
+            tasks->AddTask([h = a->CreateRefHandle(), fn]() {
+                if (auto actorNi = h.get()) {
+                    if (auto* target = actorNi.get()) fn(target);
+                }
+            });
+        }
+    };
+
+    class GameEvents final : public Gauges::Events {
+    public:
+        void hit(RE::FormID id, ERF_ElementHandle elem, int delta, int applied, double rt, float h) override {
+            if (GaugeTrace::Recording()) GaugeTrace::Hit(ActorFor(id), elem, delta, applied, rt, h);
+        }
+        void reaction(RE::FormID id, ERF_ReactionHandle rh, float hudSeconds, double rt, float h) override {
+            auto* a = ActorFor(id);
+            if (!a) return;
+            InjectHUD::BeginReaction(a, rh, hudSeconds);
+            if (GaugeTrace::Recording()) GaugeTrace::Reaction(a, rh, rt, h);
         }
+    };
+
+    void BindCore() {
+        static GameClock clock;
+        static GameActors actors;
+        static GameTasks tasks;
+        static GameEvents events;
+        RefreshTuning();
+        Gauges::Bind(Gauges::Host{&clock, &actors, &tasks, &events, &g_tuning, [] { (void)ERF::API::Caps(); }});
+    }
+}
+
+void ElementalGauges::Add(RE::Actor* a, ERF_ElementHandle elem, int delta) {
+    if (!a || delta <= 0) return;
+
+    const Hit hit{elem, delta, NowHours()};
+    AddBatch(a, std::span{&hit, 1});
+}
+
+void ElementalGauges::AddBatch(RE::Actor* a, std::span<const Hit> hits) {
+    if (!a || hits.empty()) return;
+
+    ApplyStaleMultipliers();
+    RefreshTuning();
+
+    g_batchActor = a;
+    const bool applied = Gauges::addBatch(a->GetFormID(), hits);
+    g_batchActor = nullptr;
+    if (!applied) return;
+
+    if (ERF::GetConfig().hudEnabled.load(std::memory_order_relaxed)) {
+        HUD::StartHUDTick();
     }
-    (void)MaybeTriggerPreEffectsFor(a, e, elem, static_cast<std::uint8_t>(afterI));
 }
 
 std::uint8_t ElementalGauges::Get(RE::Actor* a, ERF_ElementHandle elem) {
@@ -894,7 +650,6 @@ std::uint8_t ElementalGauges::Get(RE::Actor* a, ERF_ElementHandle elem) {
     auto it = Gauges::state().find(a->GetFormID());
     if (it == Gauges::state().end()) return 0;
     auto& e = it->second;
-    if (!e.sized) Gauges::initEntryDenseIfNeeded(e);
 
     const auto i = Gauges::idx(elem);
     const auto snap = Gauges::SnapshotDecay();
@@ -905,16 +660,13 @@ std::uint8_t ElementalGauges::Get(RE::Actor* a, ERF_ElementHandle elem) {
 void ElementalGauges::Set(RE::Actor* a, ERF_ElementHandle elem, std::uint8_t value) {
     if (!a || elem == 0) return;
 
-    auto& M = Gauges::state();
-    auto [__it, __inserted] = M.try_emplace(a->GetFormID());
-    auto& e = __it->second;
-    if (__inserted) Gauges::initEntryDenseIfNeeded(e);
+    auto& e = Gauges::acquire(a->GetFormID()).first->second;
 
     const std::size_t i = Gauges::idx(elem);
     const float nowH = NowHours();
 
     const auto snap = Gauges::SnapshotDecay();
-    Gauges::tickAll(e, nowH, snap);
+    Gauges::tickPresent(e, nowH, snap);
 
     const auto afterDecay = static_cast<int>(e.v[i]);
 
@@ -927,12 +679,12 @@ void ElementalGauges::Set(RE::Actor* a, ERF_ElementHandle elem, std::uint8_t val
 
     e.lastHitH[i] = nowH;
     e.lastEvalH[i] = nowH;
+    Gauges::queueDrainWake(e, a->GetFormID(), snap);
 }
 
 void ElementalGauges::Clear(RE::Actor* a) {
     if (!a) return;
-    auto& m = Gauges::state();
-    m.erase(a->GetFormID());
+    Gauges::erase(a->GetFormID());
 }
 
 void ElementalGauges::ForEachDecayed(const std::function<void(RE::FormID, TotalsView)>& fn) {
@@ -941,430 +693,163 @@ void ElementalGauges::ForEachDecayed(const std::function<void(RE::FormID, Totals
     const double nowRt = NowRealSeconds();
 
     const auto snap = Gauges::SnapshotDecay();
+    Gauges::pumpDeadlines(nowRt, nowH, snap);
+
     for (auto it = m.begin(); it != m.end();) {
         auto& e = it->second;
 
-        Gauges::tickAll(e, nowH, snap);
+        Gauges::tickPresent(e, nowH, snap);
+
+        if (Gauges::idle(e, nowRt, nowH)) {
+            it = Gauges::erase(it);
+            continue;
+        }
 
         const std::size_t beginE = Gauges::firstIndex();
         const std::size_t nE = e.v.size();
         const std::size_t countE = (nE > beginE) ? (nE - beginE) : 0;
 
-        bool anyElemLock = false;
-        for (std::size_t i = beginE; i < nE && !anyElemLock; ++i) {
-            const bool lockH = (i < e.blockUntilH.size()) && (e.blockUntilH[i] > nowH);
-            const bool lockRt = (i < e.blockUntilRtS.size()) && (e.blockUntilRtS[i] > nowRt);
-            anyElemLock = lockH || lockRt;
-        }
-
-        bool anyReactCd = false;
-        const std::size_t beginR = Gauges::firstIndex();
-        if (!anyReactCd && !e.reactCdH.empty()) {
-            const std::size_t nR = e.reactCdH.size();
-            for (std::size_t ri = beginR; ri < nR; ++ri) {
-                if (e.reactCdH[ri] > nowH) {
-                    anyReactCd = true;
-                    break;
-                }
-            }
-        }
-        if (!anyReactCd && !e.reactCdRtS.empty()) {
-            const std::size_t nR = e.reactCdRtS.size();
-            for (std::size_t ri = beginR; ri < nR; ++ri) {
-                if (e.reactCdRtS[ri] > nowRt) {
-                    anyReactCd = true;
-                    break;
-                }
-            }
-        }
-
-        bool anyReactFlag = false;
-        if (!e.inReaction.empty()) {
-            const std::size_t nR = e.inReaction.size();
-            for (std::size_t ri = beginR; ri < nR; ++ri) {
-                if (e.inReaction[ri] != 0) {
-                    anyReactFlag = true;
-                    break;
-                }
-            }
-        }
-
-        if (const bool anyVal = (e.sumAll > 0); !anyVal && !anyElemLock && !anyReactCd && !anyReactFlag) {
-            it = m.erase(it);
-            continue;
-        }
-
         const std::span<const std::uint8_t> spanVals{e.v.data() + beginE, countE};
-        TotalsView view{spanVals};
+        TotalsView view{spanVals, e.version};
         fn(it->first, view);
 
         ++it;
     }
 }
 
-std::optional<ElementalGauges::HudGaugeBundle> ElementalGauges::PickHudDecayed(RE::FormID id, double nowRt,
-                                                                               float nowH) {
+std::size_t ElementalGauges::Compact() {
+    return Gauges::compact(NowRealSeconds(), NowHours(), Gauges::SnapshotDecay());
+}
+
+std::uint64_t ElementalGauges::VersionOf(RE::FormID id) {
+    auto& M = Gauges::state();
+    auto it = M.find(id);
+    if (it == M.end()) return 0;
+    Gauges::tickPresent(it->second, NowHours(), Gauges::SnapshotDecay());
+    return it->second.version;
+}
+
+void ElementalGauges::BeginHudFrame() { TL_hudArena.reset(); }
+
+ElementalGauges::IconCacheStats ElementalGauges::GetIconCacheStats() noexcept {
+    return IconCacheStats{g_hudIconHits.load(std::memory_order_relaxed),
+                          g_hudIconMisses.load(std::memory_order_relaxed)};
+}
+
+bool ElementalGauges::PickHudDecayed(RE::FormID id, double nowRt, float nowH, HudGaugeOut& out) {
     auto& M = Gauges::state();
     auto it = M.find(id);
     if (it == M.end()) {
-        return std::nullopt;
+        return false;
     }
 
     auto& e = it->second;
 
     const auto snap = Gauges::SnapshotDecay();
-    Gauges::tickAll(e, nowH, snap);
-
-    HudGaugeBundle bundle{};
-
-    struct ElemInfo {
-        ERF_ElementHandle handle{};
-        std::uint8_t value{0};
-        std::uint32_t rgb{0xFFFFFF};
-        bool isolated{false};
-    };
+    Gauges::tickPresent(e, nowH, snap);
 
     const auto colors = GetColorLUT();
     const auto& ER = ElementRegistry::get();
 
-    std::vector<ElemInfo> elems;
-    elems.reserve(e.presentList.size());
-
-    int newSum = 0;
-
+    auto elems = TL_hudArena.take<HudElem>(e.presentList.size());
+    std::size_t n = 0;
     for (ERF_ElementHandle h : e.presentList) {
         const std::size_t idx = Gauges::idx(h);
-        if (idx >= e.v.size()) {
+        if (idx >= e.v.size() || e.v[idx] == 0) {
             continue;
         }
-
-        const std::uint8_t vv = e.v[idx];
-        if (vv == 0) {
-            continue;
-        }
-
-        ElemInfo info;
-        info.handle = h;
-        info.value = vv;
-        info.rgb = (idx < colors.size()) ? colors[idx] : 0xFFFFFFu;
-
-        if (const auto* d = ER.get(h)) {
-            info.isolated = d->noMixInMixedMode;
-        } else {
-            info.isolated = false;
-        }
-
-        elems.push_back(info);
-        newSum += vv;
-    }
-
-    if (newSum == 0) {
-        const std::size_t beginE = Gauges::firstIndex();
-        const std::size_t nE = e.v.size();
-
-        bool anyElemLock = false;
-        for (std::size_t i2 = beginE; i2 < nE && !anyElemLock; ++i2) {
-            const bool lockH = (i2 < e.blockUntilH.size()) && (e.blockUntilH[i2] > nowH);
-            const bool lockRt = (i2 < e.blockUntilRtS.size()) && (e.blockUntilRtS[i2] > nowRt);
-            anyElemLock = lockH || lockRt;
-        }
-
-        bool anyReactCd = false;
-        const std::size_t beginR = Gauges::firstIndex();
-
-        if (!anyReactCd && !e.reactCdH.empty()) {
-            const std::size_t nR = e.reactCdH.size();
-            for (std::size_t ri = beginR; ri < nR; ++ri) {
-                if (e.reactCdH[ri] > nowH) {
-                    anyReactCd = true;
-                    break;
-                }
-            }
-        }
-
-        if (!anyReactCd && !e.reactCdRtS.empty()) {
-            const std::size_t nR = e.reactCdRtS.size();
-            for (std::size_t ri = beginR; ri < nR; ++ri) {
-                if (e.reactCdRtS[ri] > nowRt) {
-                    anyReactCd = true;
-                    break;
-                }
-            }
-        }
-
-        bool anyReactFlag = false;
-        if (!e.inReaction.empty()) {
-            const std::size_t nR = e.inReaction.size();
-            for (std::size_t ri = beginR; ri < nR; ++ri) {
-                if (e.inReaction[ri] != 0) {
-                    anyReactFlag = true;
-                    break;
-                }
-            }
-        }
-
-        if (!anyElemLock && !anyReactCd && !anyReactFlag) {
-            M.erase(it);
-        }
-
-        bundle.icons = std::span<const char* const>();
-        bundle.values = std::span<const std::uint32_t>();
-        bundle.colors = std::span<const std::uint32_t>();
-
-        return std::nullopt;
+        const auto* d = ER.get(h);
+        elems[n++] = HudElem{h, std::min<std::uint8_t>(e.v[idx], 100),
+                             idx < colors.size() ? colors[idx] : 0xFFFFFFu, d && d->noMixInMixedMode};
     }
 
-    TL_vals32.clear();
-    TL_cols32.clear();
-    TL_accumIcons.clear();
-    TL_elemsNZ.clear();
-
-    TL_vals32.reserve(elems.size());
-    TL_cols32.reserve(elems.size());
-    TL_elemsNZ.reserve(elems.size());
-
-    const auto& RR = ReactionRegistry::get();
-
-    if (const bool singleMode = ERF::GetConfig().isSingle.load(std::memory_order_relaxed); singleMode) {
-        for (const auto& info : elems) {
-            TL_vals32.push_back(static_cast<std::uint32_t>(std::min<int>(info.value, 100)));
-            TL_cols32.push_back(info.rgb);
-            TL_elemsNZ.push_back(info.handle);
-        }
-
-        bundle.values = std::span<const std::uint32_t>(TL_vals32.data(), TL_vals32.size());
-        bundle.colors = std::span<const std::uint32_t>(TL_cols32.data(), TL_cols32.size());
-
-        TL_accumIcons.clear();
-
-        thread_local std::vector<std::uint8_t> TL_totals;
-        if (TL_totals.size() < e.v.size()) {
-            TL_totals.resize(e.v.size());
-        }
-
-        for (std::size_t k = 0; k < TL_vals32.size(); ++k) {
-            const auto elemH = TL_elemsNZ[k];
-            const auto idx = Gauges::idx(elemH);
-            if (idx >= TL_totals.size()) {
-                TL_accumIcons.push_back(nullptr);
-                continue;
-            }
-
-            std::ranges::fill(TL_totals, std::uint8_t{0});
-            const auto vClamped = static_cast<std::uint8_t>(std::min<std::uint32_t>(TL_vals32[k], 100));
-            TL_totals[idx] = vClamped;
-
-            const int sum = vClamped;
-            if (sum <= 0) {
-                TL_accumIcons.push_back(nullptr);
-                continue;
-            }
-
-            const float inv = 1.0f / static_cast<float>(sum);
-            std::array<ERF_ElementHandle, 1> present{elemH};
-            auto best = RR.pickBestFast(TL_totals, std::span<const ERF_ElementHandle>(present.data(), present.size()),
-                                        sum, inv);
-
-            const char* icon = (best && best->icon) ? best->icon : kFallbackReactionIcon;
-            TL_accumIcons.push_back(icon);
+    if (n == 0) {
+        if (!Gauges::held(e, nowRt, nowH)) {
+            Gauges::erase(it);
         }
-
-        bundle.icons = std::span<const char* const>(TL_accumIcons.data(), TL_accumIcons.size());
-        return bundle;
+        return false;
     }
+    elems = elems.first(n);
 
-    int firstMixIndex = -1;
-    for (std::size_t i3 = 0; i3 < elems.size(); ++i3) {
-        if (!elems[i3].isolated) {
-            firstMixIndex = static_cast<int>(i3);
-            break;
-        }
+    if (TL_hudTotals.size() < e.v.size()) {
+        TL_hudTotals.resize(e.v.size());
     }
 
-    if (firstMixIndex < 0) {
-        for (const auto& info : elems) {
-            TL_vals32.push_back(static_cast<std::uint32_t>(std::min<int>(info.value, 100)));
-            TL_cols32.push_back(info.rgb);
-            TL_elemsNZ.push_back(info.handle);
-        }
-
-        bundle.values = std::span<const std::uint32_t>(TL_vals32.data(), TL_vals32.size());
-        bundle.colors = std::span<const std::uint32_t>(TL_cols32.data(), TL_cols32.size());
-
-        TL_accumIcons.clear();
-
-        thread_local std::vector<std::uint8_t> TL_totalsIso;
-        if (TL_totalsIso.size() < e.v.size()) {
-            TL_totalsIso.resize(e.v.size());
-        }
-
-        for (std::size_t k2 = 0; k2 < TL_vals32.size(); ++k2) {
-            const auto elemH = TL_elemsNZ[k2];
-            const auto idx = Gauges::idx(elemH);
-            if (idx >= TL_totalsIso.size()) {
-                TL_accumIcons.push_back(nullptr);
-                continue;
-            }
-
-            std::ranges::fill(TL_totalsIso, std::uint8_t{0});
-            const auto vClamped = static_cast<std::uint8_t>(std::min<std::uint32_t>(TL_vals32[k2], 100));
-            TL_totalsIso[idx] = vClamped;
-
-            const int sum = vClamped;
-            if (sum <= 0) {
-                TL_accumIcons.push_back(nullptr);
-                continue;
-            }
-
-            const float inv = 1.0f / static_cast<float>(sum);
-            std::array<ERF_ElementHandle, 1> present{elemH};
-            auto best = RR.pickBestFast(TL_totalsIso,
-                                        std::span<const ERF_ElementHandle>(present.data(), present.size()), sum, inv);
-
-            const char* icon = (best && best->icon) ? best->icon : kFallbackReactionIcon;
+    const auto emit = [&](const HudElem& x) {
+        out.values.push_back(static_cast<double>(x.value));
+        out.colors.push_back(x.rgb);
+    };
+    const auto iconOf = [](const HudElem& x) { return PickHudIcon({&x.handle, 1}, {&x.value, 1}); };
 
-            TL_accumIcons.push_back(icon);
+    // Single mode, or mixed mode with nothing mixable: one gauge per element, in presence order.
+    const bool singleMode = ERF::GetConfig().isSingle.load(std::memory_order_relaxed);
+    const auto firstMix = singleMode ? elems.end() : std::ranges::find(elems, false, &HudElem::isolated);
+    if (firstMix == elems.end()) {
+        for (const auto& x : elems) {
+            emit(x);
         }
-
-        bundle.icons = std::span<const char* const>(TL_accumIcons.data(), TL_accumIcons.size());
-        return bundle;
-    }
-
-    std::vector<const ElemInfo*> singlesBefore;
-    std::vector<const ElemInfo*> mixList;
-    std::vector<const ElemInfo*> singlesAfter;
-
-    singlesBefore.reserve(elems.size());
-    mixList.reserve(elems.size());
-    singlesAfter.reserve(elems.size());
-
-    for (std::size_t i4 = 0; i4 < elems.size(); ++i4) {
-        const auto& info = elems[i4];
-        if (!info.isolated) {
-            mixList.push_back(&info);
-        } else if (static_cast<int>(i4) < firstMixIndex) {
-            singlesBefore.push_back(&info);
-        } else {
-            singlesAfter.push_back(&info);
+        for (const auto& x : elems) {
+            out.icons.push_back(iconOf(x));
         }
+        return true;
     }
 
-    auto pushInfo = [&](const ElemInfo* p) {
-        TL_vals32.push_back(static_cast<std::uint32_t>(std::min<int>(p->value, 100)));
-        TL_cols32.push_back(p->rgb);
-        TL_elemsNZ.push_back(p->handle);
-    };
+    // Mixed mode: isolated elements seen before the first mixable one, then the shared gauge, then the rest.
+    const auto before = std::span<const HudElem>(elems.begin(), firstMix);
+    const auto after = std::span<const HudElem>(firstMix, elems.end());
 
-    for (auto* p : singlesBefore) {
-        pushInfo(p);
+    std::size_t nm = 0;
+    for (const auto& x : before) {
+        emit(x);
     }
-    for (auto* p : mixList) {
-        pushInfo(p);
+    for (const auto& x : after) {
+        if (!x.isolated) {
+            emit(x);
+            ++nm;
+        }
     }
-    for (auto* p : singlesAfter) {
-        pushInfo(p);
+    for (const auto& x : after) {
+        if (x.isolated) {
+            emit(x);
+            ++out.singlesAfter;
+        }
     }
+    out.singlesBefore = static_cast<std::uint32_t>(before.size());
 
-    bundle.values = std::span<const std::uint32_t>(TL_vals32.data(), TL_vals32.size());
-    bundle.colors = std::span<const std::uint32_t>(TL_cols32.data(), TL_cols32.size());
-
-    TL_accumIcons.clear();
-
-    const std::size_t nb = singlesBefore.size();
-    const std::size_t nm = mixList.size();
-    const std::size_t na = singlesAfter.size();
-
-    const std::size_t gaugeCount = nb + (nm > 0 ? 1u : 0u) + na;
-    TL_accumIcons.resize(gaugeCount, nullptr);
-
-    bundle.singlesBefore = static_cast<std::uint32_t>(nb);
-    bundle.singlesAfter = static_cast<std::uint32_t>(na);
-
-    thread_local std::vector<std::uint8_t> TL_totalsSingle;
-    if (TL_totalsSingle.size() < e.v.size()) {
-        TL_totalsSingle.resize(e.v.size());
+    for (const auto& x : before) {
+        out.icons.push_back(iconOf(x));
     }
 
-    auto pickIconSingle = [&](const ElemInfo* info) -> const char* {
-        const auto elemH = info->handle;
-        const auto idx = Gauges::idx(elemH);
-        if (idx >= TL_totalsSingle.size()) {
-            return nullptr;
-        }
-
-        std::ranges::fill(TL_totalsSingle, std::uint8_t{0});
-        const auto vClamped = static_cast<std::uint8_t>(std::min<int>(info->value, 100));
-        TL_totalsSingle[idx] = vClamped;
-
-        const int sum = vClamped;
-        if (sum <= 0) {
-            return nullptr;
-        }
-
-        const float inv = 1.0f / static_cast<float>(sum);
-        std::array<ERF_ElementHandle, 1> present{elemH};
-        auto best = RR.pickBestFast(TL_totalsSingle, std::span<const ERF_ElementHandle>(present.data(), present.size()),
-                                    sum, inv);
-
-        if (best && best->icon) {
-            return best->icon;
+    auto mixHandles = TL_hudArena.take<ERF_ElementHandle>(nm);
+    auto mixValues = TL_hudArena.take<std::uint8_t>(nm);
+    std::size_t k = 0;
+    for (const auto& x : after) {
+        if (!x.isolated) {
+            mixHandles[k] = x.handle;
+            mixValues[k] = x.value;
+            ++k;
         }
-        return kFallbackReactionIcon;
-    };
-
-    for (std::size_t i5 = 0; i5 < nb; ++i5) {
-        TL_accumIcons[i5] = pickIconSingle(singlesBefore[i5]);
     }
+    out.icons.push_back(PickHudIcon(mixHandles, mixValues));
 
-    if (nm > 0) {
-        thread_local std::vector<std::uint8_t> TL_totalsMix;
-        if (TL_totalsMix.size() < e.v.size()) {
-            TL_totalsMix.resize(e.v.size());
+    for (const auto& x : after) {
+        if (x.isolated) {
+            out.icons.push_back(iconOf(x));
         }
-        std::ranges::fill(TL_totalsMix, std::uint8_t{0});
-
-        int sumMixIcons = 0;
-        std::vector<ERF_ElementHandle> presentMix;
-        presentMix.reserve(nm);
-
-        for (const auto* p : mixList) {
-            const auto elemH = p->handle;
-            const auto idx = Gauges::idx(elemH);
-            if (idx >= TL_totalsMix.size()) {
-                continue;
-            }
-            const auto vClamped = static_cast<std::uint8_t>(std::min<int>(p->value, 100));
-            TL_totalsMix[idx] = vClamped;
-            sumMixIcons += vClamped;
-            presentMix.push_back(elemH);
-        }
-
-        if (sumMixIcons > 0 && !presentMix.empty()) {
-            const float inv = 1.0f / static_cast<float>(sumMixIcons);
-            auto best = RR.pickBestFast(std::span<const std::uint8_t>(TL_totalsMix.data(), TL_totalsMix.size()),
-                                        std::span<const ERF_ElementHandle>(presentMix.data(), presentMix.size()),
-                                        sumMixIcons, inv);
-            TL_accumIcons[nb] = (best && best->icon) ? best->icon : kFallbackReactionIcon;
-        }
-    }
-
-    const std::size_t offsetAfter = nb + (nm > 0 ? 1u : 0u);
-    for (std::size_t i6 = 0; i6 < na; ++i6) {
-        TL_accumIcons[offsetAfter + i6] = pickIconSingle(singlesAfter[i6]);
     }
-
-    bundle.icons = std::span<const char* const>(TL_accumIcons.data(), TL_accumIcons.size());
-    return bundle;
+    return true;
 }
 
-void ElementalGauges::RegisterStore() { Ser::Register({Gauges::kRecordID, Gauges::kVersion, &Save, &Load, &Revert}); }
+void ElementalGauges::RegisterStore() {
+    BindCore();
+    Ser::Register({Gauges::kRecordID, Gauges::kVersion, &Save, &Load, &Revert});
+}
 
 void ElementalGauges::InvalidateStateMultipliers(RE::Actor* a) {
     if (!a) return;
-    auto& m = Gauges::state();
-    const auto it = m.find(a->GetFormID());
-    if (it == m.end()) return;
-    it->second.effDirty = true;
+    std::scoped_lock lk(g_staleLock);
+    g_stale.push_back(a->GetFormID());
+    g_anyStale.store(true, std::memory_order_release);
 }
 
 void ElementalGauges::BuildColorLUTOnce() {
@@ -8,21 +8,24 @@
 #include <utility>
 #include <vector>
 
+#include "GaugeCore.h"
 #include "RE/Skyrim.h"
 #include "SKSE/SKSE.h"
 #include "erf_element.h"
 
 namespace ElementalGauges {
-    struct HudGaugeBundle {
-        std::span<const char* const> icons;
-        std::span<const std::uint32_t> values;
-        std::span<const std::uint32_t> colors;
+    // PickHudDecayed appends straight into the widget's buffers; they keep their capacity between frames.
+    struct HudGaugeOut {
+        std::vector<double>& values;
+        std::vector<std::uint32_t>& colors;
+        std::vector<const char*>& icons;
         std::uint32_t singlesBefore{0};
         std::uint32_t singlesAfter{0};
     };
 
     struct TotalsView {
         std::span<const std::uint8_t> values;
+        std::uint64_t version{0};
         bool any() const {
             return std::ranges::any_of(values, [](auto v) { return v > 0; });
         }
@@ -34,20 +37,34 @@ namespace ElementalGauges {
         std::size_t size() const { return values.size(); }
     };
 
+    struct IconCacheStats {
+        std::uint64_t hits{0};
+        std::uint64_t misses{0};
+    };
+
+    using Hit = Gauges::Hit;
+
     std::uint8_t Get(RE::Actor* a, ERF_ElementHandle elem);
     void Set(RE::Actor* a, ERF_ElementHandle elem, std::uint8_t value);
     void Add(RE::Actor* a, ERF_ElementHandle elem, int delta);
+    void AddBatch(RE::Actor* a, std::span<const Hit> hits);
     void Clear(RE::Actor* a);
     void RegisterStore();
     void ForEachDecayed(const std::function<void(RE::FormID, TotalsView)>& fn);
-    std::optional<HudGaugeBundle> PickHudDecayed(RE::FormID id, double nowRt, float nowH);
+    // Decays every entry and drops idle, dead and vanished actors; returns how many were dropped.
+    std::size_t Compact();
+    void BeginHudFrame();
+    bool PickHudDecayed(RE::FormID id, double nowRt, float nowH, HudGaugeOut& out);
+    IconCacheStats GetIconCacheStats() noexcept;
+    std::uint64_t VersionOf(RE::FormID id);
+    // Safe from any thread: only records the actor; its cached multipliers are refreshed before its next hit.
     void InvalidateStateMultipliers(RE::Actor* a);
     void BuildColorLUTOnce();
 }
 
 namespace ElementalGaugesDecay {
-    inline constexpr float kGraceSec = 5.0f;
-    inline constexpr float kRealDecayPerSec = 15.0f;
+    inline constexpr float kGraceSec = Gauges::kGraceSec;
+    inline constexpr float kRealDecayPerSec = Gauges::kRealDecayPerSec;
 
     inline float NowHours() { return RE::Calendar::GetSingleton()->GetHoursPassed(); }
     inline float Timescale() {
@@ -1,12 +1,13 @@
 #include "ElementalGaugesHook.h"
 
+#include <ankerl/unordered_dense.h>
+
 #include <algorithm>
 #include <array>
 #include <atomic>
-#include <chrono>
 #include <cmath>
-#include <optional>
-#include <shared_mutex>
+#include <memory>
+#include <mutex>
 #include <span>
 #include <thread>
 #include <type_traits>
@@ -16,77 +17,243 @@
 #include "../Config.h"
 #include "../common/Helpers.h"
 #include "../hud/HUDTick.h"
-#include "ElementalGauges.h"
 #include "ElementalStates.h"
+#include "GaugeIngest.h"
 #include "erf_element.h"
 
-using namespace std::chrono;
-
 namespace {
-    template <class K, class V, std::size_t N = 64>
-    struct StripedMap {
-        static_assert((N & (N - 1)) == 0, "N must be power of two");
-        struct Stripe {
-            std::unordered_map<K, V> map;
-            mutable std::shared_mutex mx;
-        };
-        std::array<Stripe, N> stripes;
+    inline bool IsDisabled() noexcept { return !ERF::GetConfig().enabled.load(std::memory_order_relaxed); }
+}
 
-        static constexpr std::size_t idx(const K& k) noexcept { return std::hash<K>{}(k) & (N - 1); }
+namespace GaugesHook {
+    using Elem = ERF_ElementHandle;
 
-        std::optional<V> get(const K& k) const {
-            auto& s = stripes[idx(k)];
-            std::shared_lock lk(s.mx);
-            auto it = s.map.find(k);
-            if (it == s.map.end()) return std::nullopt;
-            return it->second;
+    // Most element MGEFs carry one or two element keywords, so up to kInlineElems handles live in place. A longer
+    // list is interned once per MGEF (see InternElems) and referenced through longElems.
+    inline constexpr std::size_t kInlineElems = 4;
+
+    inline std::span<const Elem> ElemSpan(const std::array<Elem, kInlineElems>& elems, const Elem* longElems,
+                                          std::size_t count) noexcept {
+        return {longElems ? longElems : elems.data(), count};
+    }
+
+    // One record per ActiveEffect. usUniqueID picks the home slot, but the owner pointer is the key: a slot is only
+    // taken once AEApplyRemoveSink has released its previous owner, and an effect whose home is held by another live
+    // effect (a duplicate id, or an ability still holding it after the counter wrapped) goes to the overflow table.
+    // An odd generation means another thread is mutating the record.
+    struct alignas(64) EffSlot {
+        std::atomic<std::uint32_t> gen{0};
+        RE::ActorHandle target;
+        std::atomic<const RE::ActiveEffect*> owner{nullptr};
+        std::array<Elem, kInlineElems> elems{};
+        std::uint16_t count{0};
+        std::uint8_t flags{0};
+        bool haveBase{false};
+        float baseHealthMag{0.f};
+        // Every element of an effect gains the same amount per tick, so one accumulator serves them all.
+        double accum{0.0};
+        const Elem* longElems{nullptr};
+    };
+    static_assert(sizeof(EffSlot) == 64);
+
+    class SlotGuard {
+    public:
+        explicit SlotGuard(EffSlot& s) noexcept : _s(s) {
+            for (;;) {
+                auto g = _s.gen.load(std::memory_order_relaxed);
+                if (!(g & 1u) && _s.gen.compare_exchange_weak(g, g + 1, std::memory_order_acquire)) return;
+                std::this_thread::yield();
+            }
         }
+        ~SlotGuard() { _s.gen.fetch_add(1, std::memory_order_release); }
+        SlotGuard(const SlotGuard&) = delete;
+        SlotGuard& operator=(const SlotGuard&) = delete;
 
-        template <class F>
-        void upsert(const K& k, F&& f) {
-            auto& s = stripes[idx(k)];
-            std::unique_lock lk(s.mx);
-            if (s.map.empty()) s.map.reserve(64);
-            f(s.map);
+    private:
+        EffSlot& _s;
+    };
+
+    // What the update hook needs from a slot, copied out under the generation check rather than the guard, so the
+    // handle lookup and the state multipliers run with no slot held.
+    struct SlotView {
+        const RE::ActiveEffect* owner{nullptr};
+        RE::ActorHandle target;
+        std::array<Elem, kInlineElems> elems{};
+        const Elem* longElems{nullptr};
+        std::uint16_t count{0};
+        std::uint8_t flags{0};
+
+        std::span<const Elem> span() const noexcept { return ElemSpan(elems, longElems, count); }
+    };
+
+    static SlotView ReadSlot(const EffSlot& s) noexcept {
+        for (;;) {
+            const auto g0 = s.gen.load(std::memory_order_acquire);
+            if (g0 & 1u) {
+                std::this_thread::yield();
+                continue;
+            }
+            SlotView v;
+            v.owner = s.owner.load(std::memory_order_relaxed);
+            v.target = s.target;
+            v.elems = s.elems;
+            v.longElems = s.longElems;
+            v.count = s.count;
+            v.flags = s.flags;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.gen.load(std::memory_order_relaxed) == g0) return v;
         }
+    }
+
+    static EffSlot& SlotAt(std::uint16_t uid) {
+        static auto* slab = new EffSlot[std::size_t{1} << 16];
+        return slab[uid];
+    }
+    static EffSlot& HomeSlot(const RE::ActiveEffect* ae) { return SlotAt(ae->usUniqueID); }
 
-        void erase(const K& k) {
-            auto& s = stripes[idx(k)];
-            std::unique_lock lk(s.mx);
-            s.map.erase(k);
+    // Slots for effects that found their home slot taken. Collisions are rare, so one mutex guards the table and
+    // the per-frame path skips it while it is empty. Holders keep a reference so a concurrent release cannot free
+    // a slot that is still being read.
+    class OverflowSlots {
+    public:
+        std::shared_ptr<EffSlot> find(const RE::ActiveEffect* ae) {
+            if (_size.load(std::memory_order_acquire) == 0) return nullptr;
+            std::scoped_lock lk(_mx);
+            const auto it = _map.find(ae);
+            return it != _map.end() ? it->second.slot : nullptr;
         }
 
-        template <class Pred>
-        void erase_if(Pred&& p) {
-            for (auto& s : stripes) {
-                std::unique_lock lk(s.mx);
-                std::erase_if(s.map, std::forward<Pred>(p));
+        std::shared_ptr<EffSlot> claim(const RE::ActiveEffect* ae) {
+            std::scoped_lock lk(_mx);
+            auto& e = _map[ae];
+            if (!e.slot) {
+                e.slot = std::make_shared<EffSlot>();
+                e.uid = ae->usUniqueID;
+                _size.store(_map.size(), std::memory_order_release);
             }
+            return e.slot;
         }
-    };
 
-    inline bool IsDisabled() noexcept { return !ERF::GetConfig().enabled.load(std::memory_order_relaxed); }
-}
+        // Same match as the home slot: the removed uid, on the removed target when the event names one.
+        void release(std::uint16_t uid, const RE::Actor* tgt) {
+            if (_size.load(std::memory_order_acquire) == 0) return;
+            std::scoped_lock lk(_mx);
+            std::erase_if(_map, [&](const auto& kv) {
+                if (kv.second.uid != uid) return false;
+                if (!tgt) return true;
+                SlotGuard g(*kv.second.slot);
+                const RE::Actor* a = kv.second.slot->target.get().get();
+                return a && a == tgt;
+            });
+            _size.store(_map.size(), std::memory_order_release);
+        }
 
-namespace GaugesHook {
-    using Elem = ERF_ElementHandle;
+    private:
+        struct Held {
+            std::shared_ptr<EffSlot> slot;
+            std::uint16_t uid{0};
+        };
 
-    struct EffCtx {
-        RE::ActorHandle target;
-        std::vector<Elem> elems;
-        std::uint16_t uid;
+        std::unordered_map<const RE::ActiveEffect*, Held> _map;
+        std::atomic<std::size_t> _size{0};
+        std::mutex _mx;
     };
 
-    static StripedMap<std::uint64_t, double, 64> g_lastAccHint;
-    static StripedMap<std::uint64_t, std::uint16_t, 64> g_lastAccCarrierUID;
-    static StripedMap<const RE::ActiveEffect*, float, 64> g_baseHealthMag;
-    static StripedMap<const RE::ActiveEffect*, EffCtx, 64> g_ctx;
-    static StripedMap<std::uint64_t, double, 64> g_accum;
+    static OverflowSlots g_overflowSlots;
 
-    static std::uint64_t KeyActorOnly(const RE::Actor* a) noexcept {
-        return static_cast<std::uint64_t>(a ? a->GetFormID() : 0);
+    // The slot self already owns, or null. keep pins an overflow slot for as long as the caller uses it.
+    static EffSlot* FindSlot(const RE::ActiveEffect* self, std::shared_ptr<EffSlot>& keep) {
+        if (auto& home = HomeSlot(self); home.owner.load(std::memory_order_acquire) == self) return &home;
+        keep = g_overflowSlots.find(self);
+        return keep.get();
     }
 
+    // Last gauge-accumulation hint per actor. Writers are rare (carrier apply/remove) and serialise on a mutex;
+    // the per-frame readers only touch atomics and retry on a torn read.
+    class AccHintTable {
+    public:
+        double get(RE::FormID id) const noexcept {
+            if (!id) return 0.0;
+            for (std::size_t i = 0, at = hash(id); i < kCap; ++i, at = (at + 1) & (kCap - 1)) {
+                const auto& e = _slots[at];
+                for (;;) {
+                    const auto v0 = e.seq.load(std::memory_order_acquire);
+                    if (v0 & 1u) continue;
+                    const auto key = e.key.load(std::memory_order_relaxed);
+                    const auto hint = e.hint.load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (e.seq.load(std::memory_order_relaxed) != v0) continue;
+                    if (key == 0) return 0.0;
+                    if (key == id) return hint;
+                    break;
+                }
+            }
+            return 0.0;
+        }
+
+        void set(RE::FormID id, double hint, std::uint16_t carrierUID) {
+            if (!id) return;
+            std::scoped_lock lk(_writeMx);
+            if (auto* e = claim(id)) write(*e, id, hint, carrierUID);
+        }
+
+        void clearIfCarrier(RE::FormID id, std::uint16_t carrierUID) {
+            if (!id) return;
+            std::scoped_lock lk(_writeMx);
+            if (auto* e = find(id); e && e->carrierUID == carrierUID) write(*e, id, 0.0, 0);
+        }
+
+    private:
+        static constexpr std::size_t kCap = 4096;
+
+        struct Slot {
+            std::atomic<std::uint32_t> seq{0};
+            std::atomic<RE::FormID> key{0};
+            std::atomic<double> hint{0.0};
+            std::uint16_t carrierUID{0};
+        };
+
+        static std::size_t hash(RE::FormID id) noexcept {
+            return static_cast<std::size_t>((id * 0x9E3779B1u) >> 20) & (kCap - 1);
+        }
+
+        Slot* find(RE::FormID id) {
+            for (std::size_t i = 0, at = hash(id); i < kCap; ++i, at = (at + 1) & (kCap - 1)) {
+                const auto key = _slots[at].key.load(std::memory_order_relaxed);
+                if (key == id) return &_slots[at];
+                if (key == 0) return nullptr;
+            }
+            return nullptr;
+        }
+
+        Slot* claim(RE::FormID id) {
+            Slot* reusable = nullptr;
+            for (std::size_t i = 0, at = hash(id); i < kCap; ++i, at = (at + 1) & (kCap - 1)) {
+                auto& e = _slots[at];
+                const auto key = e.key.load(std::memory_order_relaxed);
+                if (key == id) return &e;
+                if (key == 0) return reusable ? reusable : &e;
+                if (!reusable && e.hint.load(std::memory_order_relaxed) <= 0.0) reusable = &e;
+            }
+            return reusable;
+        }
+
+        static void write(Slot& e, RE::FormID id, double hint, std::uint16_t carrierUID) {
+            const auto v = e.seq.load(std::memory_order_relaxed);
+            e.seq.store(v + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            e.key.store(id, std::memory_order_relaxed);
+            e.hint.store(hint, std::memory_order_relaxed);
+            e.carrierUID = carrierUID;
+            e.seq.store(v + 2, std::memory_order_release);
+        }
+
+        std::array<Slot, kCap> _slots{};
+        std::mutex _writeMx;
+    };
+
+    static AccHintTable g_accHints;
+
     static RE::EffectSetting* LookupMGEF(const char* edid, std::uint32_t formID = 0) {
         if (auto* m = RE::TESForm::LookupByEditorID<RE::EffectSetting>(edid)) return m;
         if (formID) return RE::TESForm::LookupByID<RE::EffectSetting>(formID);
@@ -100,26 +267,133 @@ namespace GaugesHook {
         return carrier && (mgef == carrier);
     }
 
-    static std::vector<Elem> ClassifyElements(const RE::EffectSetting* mgef) {
-        std::vector<Elem> out;
-        if (!mgef || IsGaugeAccCarrier(mgef)) return out;
+    enum EffFlag : std::uint8_t {
+        kDetrimentalHealth = 1u << 0,
+        kNoDuration = 1u << 1,
+        kGaugeCarrier = 1u << 2,
+    };
+
+    struct EffClass {
+        std::array<Elem, kInlineElems> elems{};
+        const Elem* longElems{nullptr};
+        std::uint16_t count{0};
+        std::uint8_t flags{0};
+
+        std::span<const Elem> span() const noexcept { return ElemSpan(elems, longElems, count); }
+        bool has(EffFlag f) const noexcept { return (flags & f) != 0; }
+    };
+
+    using EffClassTable = ankerl::unordered_dense::map<const RE::EffectSetting*, EffClass>;
+
+    static std::atomic<const EffClassTable*> g_effClasses{nullptr};
+    static std::atomic_bool g_dataLoaded{false};
+
+    // Element lists longer than kInlineElems, one per MGEF. Entries are never erased and the map is node-based, so
+    // the returned pointer stays valid for slots and cached classes alike.
+    static const Elem* InternElems(const RE::EffectSetting* mgef, std::vector<Elem> elems) {
+        static std::mutex mx;
+        static std::unordered_map<const RE::EffectSetting*, std::vector<Elem>> lists;
+        std::scoped_lock lk(mx);
+        auto [it, inserted] = lists.try_emplace(mgef, std::move(elems));
+        return it->second.data();
+    }
+
+    static EffClass ClassifyNow(const RE::EffectSetting* mgef) {
+        EffClass out;
+        if (!mgef) return out;
 
+        using Flag = RE::EffectSetting::EffectSettingData::Flag;
+        if (mgef->data.primaryAV == RE::ActorValue::kHealth && mgef->data.flags.any(Flag::kDetrimental)) {
+            out.flags |= kDetrimentalHealth;
+        }
+        if (mgef->data.flags.any(Flag::kNoDuration)) {
+            out.flags |= kNoDuration;
+        }
+        if (IsGaugeAccCarrier(mgef)) {
+            out.flags |= kGaugeCarrier;
+            return out;
+        }
+
+        std::vector<Elem> more;
         const auto kws = mgef->GetKeywords();
         for (RE::BGSKeyword const* kw : kws) {
             if (!kw) continue;
-            if (auto h = ElementRegistry::get().findByKeyword(kw)) {
-                if (std::find(out.begin(), out.end(), *h) == out.end()) {
-                    out.push_back(*h);
-                }
+            auto h = ElementRegistry::get().findByKeyword(kw);
+            if (!h) continue;
+
+            const auto seen = more.empty() ? out.span() : std::span<const Elem>(more);
+            if (std::ranges::find(seen, *h) != seen.end()) continue;
+            if (more.empty() && out.count < kInlineElems) {
+                out.elems[out.count++] = *h;
+                continue;
             }
+            if (more.empty()) more.assign(out.elems.begin(), out.elems.end());
+            more.push_back(*h);
+        }
+        if (!more.empty()) {
+            out.count = static_cast<std::uint16_t>(more.size());
+            out.longElems = InternElems(mgef, std::move(more));
         }
         return out;
     }
 
-    static std::uint64_t MakeKey(const RE::Actor* a, Elem e) {
-        const auto hi = static_cast<std::uint64_t>(a ? a->GetFormID() : 0);
-        const auto lo = static_cast<std::uint64_t>(e);
-        return (hi << 32) | lo;
+    static EffClass Classify(const RE::EffectSetting* mgef) {
+        if (!mgef) return {};
+        if (const auto* t = g_effClasses.load(std::memory_order_acquire)) {
+            if (auto it = t->find(mgef); it != t->end()) return it->second;
+        }
+        return ClassifyNow(mgef);
+    }
+
+    static void BuildEffClassesOnce() {
+        static std::mutex mx;
+        std::scoped_lock lk(mx);
+
+        if (g_effClasses.load(std::memory_order_relaxed)) return;
+        if (!g_dataLoaded.load(std::memory_order_acquire) || !ElementRegistry::get().isFrozen()) return;
+
+        auto* dh = RE::TESDataHandler::GetSingleton();
+        if (!dh) return;
+
+        auto* table = new EffClassTable();
+        const auto& mgefs = dh->GetFormArray<RE::EffectSetting>();
+        table->reserve(mgefs.size());
+        for (const auto* mgef : mgefs) {
+            if (mgef) table->emplace(mgef, ClassifyNow(mgef));
+        }
+        g_effClasses.store(table, std::memory_order_release);
+    }
+
+    static void ResetSlot(EffSlot& slot, const RE::ActiveEffect* self, RE::Actor* actor, const EffClass& cls) {
+        slot.target = actor->CreateRefHandle();
+        slot.count = cls.count;
+        slot.flags = cls.flags;
+        slot.elems = cls.elems;
+        slot.longElems = cls.longElems;
+        slot.haveBase = false;
+        slot.baseHealthMag = 0.f;
+        slot.accum = 0.0;
+        slot.owner.store(self, std::memory_order_release);
+    }
+
+    // Resets the slot self owns, taking its home slot if that is free and an overflow slot otherwise. A home slot
+    // whose owner is still live is never taken over.
+    static EffSlot* ClaimSlot(const RE::ActiveEffect* self, RE::Actor* actor, const EffClass& cls,
+                              std::shared_ptr<EffSlot>& keep) {
+        auto& home = HomeSlot(self);
+        keep = g_overflowSlots.find(self);
+        if (!keep) {
+            SlotGuard g(home);
+            if (const auto* cur = home.owner.load(std::memory_order_relaxed); !cur || cur == self) {
+                ResetSlot(home, self, actor, cls);
+                return &home;
+            }
+        }
+
+        if (!keep) keep = g_overflowSlots.claim(self);
+        SlotGuard g(*keep);
+        ResetSlot(*keep, self, actor, cls);
+        return keep.get();
     }
 
     class AEApplyRemoveSink final : public RE::BSTEventSink<RE::TESActiveEffectApplyRemoveEvent> {
@@ -137,26 +411,20 @@ namespace GaugesHook {
             const RE::Actor* tgt = e->target ? e->target->As<RE::Actor>() : nullptr;
 
             if (!e->isApplied) {
-                g_ctx.erase_if([&](auto& kv) {
-                    const auto* ae = kv.first;
-                    const auto& ctx = kv.second;
-                    if (ctx.uid != uid) return false;
-                    if (tgt) {
-                        const RE::Actor* a = ctx.target.get().get();
-                        if (!a || a != tgt) return false;
+                auto& slot = SlotAt(uid);
+                if (slot.owner.load(std::memory_order_acquire)) {
+                    SlotGuard g(slot);
+                    const RE::Actor* a = slot.target.get().get();
+                    if (!tgt || (a && a == tgt)) {
+                        slot.owner.store(nullptr, std::memory_order_release);
+                        slot.count = 0;
                     }
+                }
 
-                    g_baseHealthMag.erase(ae);
-                    return true;
-                });
+                g_overflowSlots.release(uid, tgt);
 
                 if (tgt) {
-                    const auto key = KeyActorOnly(tgt);
-                    const auto removedUID = uid;
-                    if (auto carrierUID = g_lastAccCarrierUID.get(key); carrierUID && *carrierUID == removedUID) {
-                        g_lastAccHint.erase(key);
-                        g_lastAccCarrierUID.erase(key);
-                    }
+                    g_accHints.clearIfCarrier(tgt->GetFormID(), uid);
                 }
             }
             return RE::BSEventNotifyControl::kContinue;
@@ -175,24 +443,20 @@ namespace GaugesHook {
         using Fn = void(T*, RE::MagicTarget*);
         static inline Fn* _orig{};
 
-        static bool IsInstantaneous(const RE::EffectSetting* mgef, const T* self) {
-            const bool noDurationFlag =
-                (mgef && (mgef->data.flags.any(RE::EffectSetting::EffectSettingData::Flag::kNoDuration)));
+        static bool IsInstantaneous(std::uint8_t flags, const T* self) {
             const bool zeroDur = (self && self->duration <= 0.01f);
-            return noDurationFlag || zeroDur;
+            return (flags & kNoDuration) != 0 || zeroDur;
         }
 
         static void thunk(T* self, RE::MagicTarget* mt) {
             if (!IsDisabled() && self) {
                 const RE::EffectSetting* mgefPre = self->GetBaseObject();
                 RE::Actor* actorPre = AsActor(self->target);
-                if (mgefPre && actorPre && !IsGaugeAccCarrier(mgefPre)) {
-                    if (auto elemsPre = ClassifyElements(mgefPre); !elemsPre.empty()) {
-                        if (mgefPre->data.primaryAV == RE::ActorValue::kHealth &&
-                            mgefPre->data.flags.any(RE::EffectSetting::EffectSettingData::Flag::kDetrimental) &&
-                            IsInstantaneous(mgefPre, self)) {
+                if (mgefPre && actorPre) {
+                    if (const auto pre = Classify(mgefPre); pre.count > 0) {
+                        if (pre.has(kDetrimentalHealth) && IsInstantaneous(pre.flags, self)) {
                             double healthMult = 1.0;
-                            for (auto elem : elemsPre) {
+                            for (auto elem : pre.span()) {
                                 if (!elem) continue;
                                 healthMult *= ElementalStates::GetHealthMultiplierFor(actorPre, elem);
                             }
@@ -212,30 +476,26 @@ namespace GaugesHook {
             RE::Actor* actor = AsActor(self ? self->target : nullptr);
             if (!mgef || !actor) return;
 
-            if (IsGaugeAccCarrier(mgef)) {
+            const auto cls = Classify(mgef);
+            if (cls.has(kGaugeCarrier)) {
                 auto acc = static_cast<double>(self->magnitude);
                 if (acc <= 0.001 && self->effect) {
                     acc = static_cast<double>(self->effect->effectItem.magnitude);
                 }
                 if (acc <= 0.001) acc = 1.0;
-                const auto k = KeyActorOnly(actor);
-                g_lastAccHint.upsert(k, [&](auto& mp) { mp[k] = acc; });
-                g_lastAccCarrierUID.upsert(k, [&](auto& mp) { mp[k] = self->usUniqueID; });
+                g_accHints.set(actor->GetFormID(), acc, self->usUniqueID);
                 return;
             }
 
-            if (auto elems = ClassifyElements(mgef); !elems.empty()) {
-                g_ctx.upsert(self,
-                             [&](auto& mp) { mp[self] = EffCtx{actor->CreateRefHandle(), elems, self->usUniqueID}; });
-
-                if (IsInstantaneous(mgef, self)) {
-                    double acc = g_lastAccHint.get(KeyActorOnly(actor)).value_or(0.0);
-                    if (acc > 0.001) {
-                        const int inc = std::max(1, (int)std::lround(acc));
-                        ElementalGaugesHook::StartHUDTick();
-                        for (auto elem : elems) {
-                            ElementalGauges::Add(actor, elem, inc);
-                        }
+            std::shared_ptr<EffSlot> keep;
+            ClaimSlot(self, actor, cls, keep);
+
+            if (cls.count > 0 && IsInstantaneous(cls.flags, self)) {
+                if (const double acc = g_accHints.get(actor->GetFormID()); acc > 0.001) {
+                    const int inc = std::max(1, (int)std::lround(acc));
+                    ElementalGaugesHook::StartHUDTick();
+                    for (auto elem : cls.span()) {
+                        GaugeIngest::Push(actor, elem, inc);
                     }
                 }
             }
@@ -260,103 +520,70 @@ namespace GaugesHook {
                 return;
             }
 
-            const auto* mgef = self->GetBaseObject();
-            if (mgef && IsGaugeAccCarrier(mgef)) {
-                _orig(self, dt);
-                return;
-            }
-
-            RE::Actor* target = nullptr;
-            std::vector<Elem> elems;
-            bool haveCtx = false;
-
-            if (auto c = g_ctx.get(self)) {
-                haveCtx = true;
-                target = c->target.get().get();
-                elems = c->elems;
-            }
-
-            if (!haveCtx) {
+            std::shared_ptr<EffSlot> keep;
+            auto* found = FindSlot(self, keep);
+            if (!found) {
+                const auto* mgef = self->GetBaseObject();
                 RE::Actor* actor = AsActor(self->target);
-                if (mgef && actor) {
-                    auto ce = ClassifyElements(mgef);
-                    if (!ce.empty()) {
-                        g_ctx.upsert(
-                            self, [&](auto& mp) { mp[self] = EffCtx{actor->CreateRefHandle(), ce, self->usUniqueID}; });
-                        target = actor;
-                        elems = std::move(ce);
-                        haveCtx = true;
-                    }
+                if (!mgef || !actor) {
+                    _orig(self, dt);
+                    return;
                 }
+                found = ClaimSlot(self, actor, Classify(mgef), keep);
             }
+            auto& slot = *found;
 
-            if (!haveCtx || !target || elems.empty()) {
-                _orig(self, dt);
-                return;
-            }
+            const auto view = ReadSlot(slot);
+            RE::Actor* target = view.owner == self && view.count > 0 ? view.target.get().get() : nullptr;
+            std::size_t count = target ? view.count : 0;
+            const auto elems = view.span();
 
-            if (mgef && mgef->data.primaryAV == RE::ActorValue::kHealth &&
-                mgef->data.flags.any(RE::EffectSetting::EffectSettingData::Flag::kDetrimental)) {
-                const bool noDurationFlag =
-                    mgef->data.flags.any(RE::EffectSetting::EffectSettingData::Flag::kNoDuration);
+            bool scaleHealth = false;
+            double healthMult = 1.0;
+            if (target && (view.flags & kDetrimentalHealth)) {
                 const bool zeroDur = (self && self->duration <= 0.01f);
-                const bool isInstant = noDurationFlag || zeroDur;
-
-                if (!isInstant) {
-                    float baseMag = self->magnitude;
-                    g_baseHealthMag.upsert(self, [&](auto& mp) {
-                        auto it = mp.find(self);
-                        if (it == mp.end()) {
-                            mp[self] = baseMag;
-                        } else {
-                            baseMag = it->second;
-                        }
-                    });
-
-                    double healthMult = 1.0;
-                    for (auto elem : elems) {
-                        if (elem == 0) {
-                            continue;
-                        }
-                        healthMult *= ElementalStates::GetHealthMultiplierFor(target, elem);
+                scaleHealth = !((view.flags & kNoDuration) || zeroDur);
+                for (std::size_t i = 0; scaleHealth && i < count; ++i) {
+                    if (elems[i] == 0) {
+                        continue;
                     }
-
-                    self->magnitude = baseMag * static_cast<float>(healthMult);
+                    healthMult *= ElementalStates::GetHealthMultiplierFor(target, elems[i]);
                 }
             }
-
-            const double accPerSec = g_lastAccHint.get(KeyActorOnly(target)).value_or(0.0);
-            if (accPerSec <= 0.001) {
-                _orig(self, dt);
-                return;
-            }
-
-            int totalInc = 0;
-
-            if (dt > 0.0f) {
-                for (auto elem : elems) {
-                    int inc = 0;
-
-                    const auto key = MakeKey(target, elem);
-                    g_accum.upsert(key, [&](auto& mp) {
-                        double& acc = mp[key];
-                        if (mp.size() == 1) mp.reserve(64);
-                        acc += accPerSec * static_cast<double>(dt);
-                        const auto whole = static_cast<int>(std::floor(acc));
-                        if (whole >= 1) {
-                            inc = whole;
-                            acc -= whole;
-                        }
-                    });
-
-                    if (inc > 0) {
-                        totalInc += inc;
-                        ElementalGauges::Add(target, elem, inc);
+            const double accPerSec = target ? g_accHints.get(target->GetFormID()) : 0.0;
+            const bool accumulate = accPerSec > 0.001 && dt > 0.0f;
+
+            int inc = 0;
+            float baseHealthMag = 0.f;
+            if (scaleHealth || accumulate) {
+                SlotGuard g(slot);
+                if (slot.owner.load(std::memory_order_relaxed) != self) {
+                    scaleHealth = false;
+                    count = 0;
+                }
+                if (scaleHealth) {
+                    if (!slot.haveBase) {
+                        slot.baseHealthMag = self->magnitude;
+                        slot.haveBase = true;
+                    }
+                    baseHealthMag = slot.baseHealthMag;
+                }
+                if (accumulate && count > 0) {
+                    slot.accum += accPerSec * static_cast<double>(dt);
+                    if (const auto whole = static_cast<int>(std::floor(slot.accum)); whole >= 1) {
+                        inc = whole;
+                        slot.accum -= whole;
                     }
                 }
             }
+            if (scaleHealth) {
+                self->magnitude = baseHealthMag * static_cast<float>(healthMult);
+            }
 
-            if (totalInc > 0) {
+            if (inc > 0 && count > 0) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    GaugeIngest::Push(target, elems[i], inc);
+                }
                 ElementalGaugesHook::StartHUDTick();
             }
 
@@ -386,29 +613,6 @@ namespace GaugesHook {
     }
 }
 
-namespace HookThread {
-    static std::atomic<long long> g_lastHookMs{0};
-    static std::atomic_bool g_monitorRunning{false};
-
-    static void EnsureWatchdog() {
-        if (bool expected = false; !g_monitorRunning.compare_exchange_strong(expected, true)) return;
-
-        std::thread([] {
-            const auto timeout = 15s;
-            for (;;) {
-                std::this_thread::sleep_for(1s);
-                const auto last_local = milliseconds(g_lastHookMs.load(std::memory_order_relaxed));
-                const auto now = duration_cast<milliseconds>(steady_clock::now().time_since_epoch());
-                if (now - last_local > timeout) {
-                    HUD::StopHUDTick();
-                    g_monitorRunning.store(false, std::memory_order_release);
-                    break;
-                }
-            }
-        }).detach();
-    }
-}
-
 std::atomic_bool& ElementalGaugesHook::AllowHudTickFlag() noexcept {
     static std::atomic_bool flag{false};
     return flag;
@@ -424,16 +628,13 @@ void ElementalGaugesHook::StartHUDTick() {
         return;
     }
     if (!AllowHudTickFlag().load(std::memory_order_acquire)) return;
-
-    const auto now = duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
-    HookThread::g_lastHookMs.store(now, std::memory_order_relaxed);
     HUD::StartHUDTick();
-    HookThread::EnsureWatchdog();
 }
 
 void ElementalGaugesHook::StopHUDTick() { HUD::StopHUDTick(); }
 void ElementalGaugesHook::Install() { GaugesHook::InstallAll(); }
 void ElementalGaugesHook::RegisterAEEventSink() { GaugesHook::RegisterAEEventSinkImpl(); }
+void ElementalGaugesHook::BuildEffectClassCache() { GaugesHook::BuildEffClassesOnce(); }
 
 void ElementalGaugesHook::InitCarrierRefs() {
     using namespace GaugesHook;
@@ -447,4 +648,7 @@ void ElementalGaugesHook::InitCarrierRefs() {
     if (!mgefGaugeAcc) {
         mgefGaugeAcc = LookupMGEF("ERF_GaugeAccEffect");
     }
+
+    g_dataLoaded.store(true, std::memory_order_release);
+    BuildEffClassesOnce();
 }
\ No newline at end of file
@@ -13,4 +13,5 @@ namespace ElementalGaugesHook {
     void Install();
     void RegisterAEEventSink();
     void InitCarrierRefs();
+    void BuildEffectClassCache();
 }
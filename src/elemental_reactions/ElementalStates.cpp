@@ -1,83 +1,367 @@
 #include "ElementalStates.h"
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cstddef>
-#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
 #include <utility>
+#include <vector>
 
 #include "../common/Helpers.h"
 #include "../common/PluginSerialization.h"
+#include "ElementMask.h"
 #include "ElementalGauges.h"
+#include "RegistrySchema.h"
 #include "erf_state.h"
 
 namespace {
+    inline constexpr std::size_t kStateWords = 4;
+    using StateMask = ElementMask<kStateWords>;
+
+    inline constexpr std::uint32_t kNoRow = 0xFFFFFFFFu;
+
     struct PerActorStates {
-        std::unordered_set<ERF_StateHandle> active;
+        RE::FormID id{0};
+        std::uint32_t row{kNoRow};
+        std::uint32_t rowGen{0};
+        StateMask active{};
     };
 
-    using StoreT = std::unordered_map<RE::FormID, PerActorStates>;
+    // Linear-probing table keyed by FormID; id 0 marks an empty slot. Deletes shift the run back, so no tombstones.
+    class StateTable {
+    public:
+        PerActorStates* find(RE::FormID id) noexcept {
+            if (_count == 0) return nullptr;
+            for (std::size_t i = home(id);; i = (i + 1) & _mask) {
+                auto& s = _slots[i];
+                if (s.id == id) return &s;
+                if (s.id == 0) return nullptr;
+            }
+        }
+
+        PerActorStates& insert(RE::FormID id) {
+            if (auto* s = find(id)) return *s;
+            if ((_count + 1) * 4 > _slots.size() * 3) grow();
+            std::size_t i = home(id);
+            while (_slots[i].id != 0) i = (i + 1) & _mask;
+            _slots[i] = PerActorStates{};
+            _slots[i].id = id;
+            ++_count;
+            return _slots[i];
+        }
+
+        void erase(PerActorStates& victim) noexcept {
+            auto hole = static_cast<std::size_t>(&victim - _slots.data());
+            _slots[hole] = PerActorStates{};
+            --_count;
+            for (std::size_t i = (hole + 1) & _mask; _slots[i].id != 0; i = (i + 1) & _mask) {
+                const std::size_t want = home(_slots[i].id);
+                if (((i - want) & _mask) >= ((i - hole) & _mask)) {
+                    _slots[hole] = _slots[i];
+                    _slots[i] = PerActorStates{};
+                    hole = i;
+                }
+            }
+        }
+
+        void clear() noexcept {
+            std::ranges::fill(_slots, PerActorStates{});
+            _count = 0;
+        }
+
+        std::size_t size() const noexcept { return _count; }
+
+        template <class F>
+        void forEach(F&& fn) {
+            for (auto& s : _slots) {
+                if (s.id != 0) fn(s);
+            }
+        }
+
+    private:
+        std::size_t home(RE::FormID id) const noexcept {
+            return static_cast<std::size_t>((std::uint64_t{id} * 0x9E3779B97F4A7C15ull) >> _shift);
+        }
 
-    StoreT& GetStore() {
-        static StoreT store;  // NOSONAR - intentional function-local static singleton
+        void grow() {
+            auto old = std::move(_slots);
+            const std::size_t cap = old.empty() ? 64 : old.size() * 2;
+            _slots.assign(cap, PerActorStates{});
+            _mask = cap - 1;
+            _shift = 64 - static_cast<unsigned>(std::countr_zero(cap));
+            _count = 0;
+            for (const auto& s : old) {
+                if (s.id == 0) continue;
+                std::size_t i = home(s.id);
+                while (_slots[i].id != 0) i = (i + 1) & _mask;
+                _slots[i] = s;
+                ++_count;
+            }
+        }
+
+        std::vector<PerActorStates> _slots;
+        std::size_t _mask{0};
+        unsigned _shift{64};
+        std::size_t _count{0};
+    };
+
+    // One row of gauge and health products per actor with any state on, indexed by element handle.
+    struct MultRows {
+        std::size_t width{0};
+        std::vector<float> gauge;
+        std::vector<float> health;
+        std::vector<std::uint32_t> freeRows;
+
+        std::uint32_t acquire() {
+            if (!freeRows.empty()) {
+                const auto r = freeRows.back();
+                freeRows.pop_back();
+                return r;
+            }
+            const auto r = static_cast<std::uint32_t>(gauge.size() / width);
+            gauge.resize(gauge.size() + width);
+            health.resize(health.size() + width);
+            return r;
+        }
+        void release(std::uint32_t r) { freeRows.push_back(r); }
+        std::span<float> gaugeAt(std::uint32_t r) { return {gauge.data() + std::size_t{r} * width, width}; }
+        std::span<float> healthAt(std::uint32_t r) { return {health.data() + std::size_t{r} * width, width}; }
+    };
+
+    struct Store {
+        std::shared_mutex lock;
+        StateTable table;
+        MultRows rows;
+    };
+
+    Store& GetStore() {
+        static Store store;  // NOSONAR - intentional function-local static singleton
         return store;
     }
 
     inline RE::FormID IdOf(RE::Actor* a) { return a ? a->GetFormID() : 0; }
 
+    inline bool InRange(ERF_StateHandle sh) { return sh != 0 && sh <= StateMask::kBits; }
+
+    template <class F>
+    void ForEachActive(const StateMask& m, F&& fn) {
+        for (std::size_t w = 0; w < StateMask::kWords; ++w) {
+            for (auto bits = m.w[w]; bits; bits &= bits - 1) {
+                fn(static_cast<ERF_StateHandle>(w * 64 + static_cast<std::size_t>(std::countr_zero(bits)) + 1));
+            }
+        }
+    }
+
+    void ReleaseRow(Store& S, PerActorStates& st) {
+        if (st.row == kNoRow) return;
+        S.rows.release(st.row);
+        st.row = kNoRow;
+    }
+
+    // Caller holds the store lock exclusively.
+    void RefreshRow(Store& S, PerActorStates& st) {
+        if (!st.active.any()) {
+            ReleaseRow(S, st);
+            return;
+        }
+
+        auto const& SR = StateRegistry::get();
+        std::size_t width = SR.elementStride();
+        if (width == 0) width = ElementRegistry::get().size() + 1;
+        if (S.rows.width != width) {
+            S.table.forEach([](PerActorStates& s) { s.row = kNoRow; });
+            S.rows = MultRows{width, {}, {}, {}};
+        }
+        if (st.row == kNoRow) st.row = S.rows.acquire();
+
+        SR.productOver(st.active.w, S.rows.gaugeAt(st.row), S.rows.healthAt(st.row));
+        st.rowGen = SR.multipliersGeneration();
+    }
+
+    std::span<const float> FreshGaugeRow(Store& S, RE::FormID id, std::shared_lock<std::shared_mutex>& shared) {
+        const auto* st = S.table.find(id);
+        if (!st || !st->active.any()) return {};
+        if (st->row != kNoRow && st->rowGen == StateRegistry::get().multipliersGeneration()) {
+            return S.rows.gaugeAt(st->row);
+        }
+
+        shared.unlock();
+        {
+            std::unique_lock lk(S.lock);
+            if (auto* w = S.table.find(id); w && w->active.any()) RefreshRow(S, *w);
+        }
+        shared.lock();
+
+        st = S.table.find(id);
+        if (!st || st->row == kNoRow) return {};
+        return S.rows.gaugeAt(st->row);
+    }
+
+    bool AnyNotOne(std::span<const float> row) {
+        return std::ranges::any_of(row, [](float m) { return m != 1.0f; });
+    }
+
+    // Swaps in the new state set under the exclusive lock. Returns true when any element's gauge product moved,
+    // which is the only case the gauge cache has to hear about.
+    bool ReplaceMask(Store& S, RE::FormID id, const StateMask& next) {
+        auto* st = S.table.find(id);
+        if (!st) {
+            if (!next.any()) return false;
+            st = &S.table.insert(id);
+        }
+        if (st->active == next) return false;
+
+        thread_local std::vector<float> before;
+        const bool hadStates = st->active.any();
+        const bool rowFresh = st->row != kNoRow && st->rowGen == StateRegistry::get().multipliersGeneration();
+        if (rowFresh) {
+            const auto row = S.rows.gaugeAt(st->row);
+            before.assign(row.begin(), row.end());
+        }
+
+        st->active = next;
+        if (!next.any()) {
+            ReleaseRow(S, *st);
+            S.table.erase(*st);
+            return rowFresh ? AnyNotOne(before) : hadStates;
+        }
+
+        RefreshRow(S, *st);
+        const auto after = S.rows.gaugeAt(st->row);
+        if (!hadStates) return AnyNotOne(after);
+        if (!rowFresh || before.size() != after.size()) return true;
+        return !std::ranges::equal(before, after);
+    }
+
+    // Returns the first handle that did not fit, or 0 when every handle made it into the mask.
+    ERF_StateHandle MaskFrom(std::span<const ERF_StateHandle> states, StateMask& out) {
+        out = StateMask{};
+        ERF_StateHandle dropped = 0;
+        for (auto sh : states) {
+            if (InRange(sh)) {
+                out.set(sh - 1u);
+            } else if (sh != 0 && dropped == 0) {
+                dropped = sh;
+            }
+        }
+        return dropped;
+    }
+
+    void WarnOutOfRange(ERF_StateHandle sh) {
+        static std::atomic_bool warned{false};
+        if (!warned.exchange(true)) {
+            spdlog::warn("[ERF] state handle {} is past the {} states an actor can hold; ignored.", sh,
+                         StateMask::kBits);
+        }
+    }
+
+    bool RowFresh(const Store& S, const PerActorStates& st, ERF_ElementHandle elem) {
+        return st.row != kNoRow && st.rowGen == StateRegistry::get().multipliersGeneration() && elem < S.rows.width;
+    }
+
+    ERF_StateElementMult MultipliersFor(RE::Actor* a, ERF_ElementHandle elem) {
+        constexpr ERF_StateElementMult kNone{1.0, 1.0};
+        if (!a || elem == 0) return kNone;
+
+        const auto id = IdOf(a);
+        auto& S = GetStore();
+        {
+            std::shared_lock lk(S.lock);
+            const auto* st = S.table.find(id);
+            if (!st || !st->active.any()) return kNone;
+            if (RowFresh(S, *st, elem)) {
+                const std::size_t at = std::size_t{st->row} * S.rows.width + elem;
+                return ERF_StateElementMult{S.rows.gauge[at], S.rows.health[at]};
+            }
+        }
+
+        std::unique_lock lk(S.lock);
+        auto* st = S.table.find(id);
+        if (!st || !st->active.any()) return kNone;
+        if (!RowFresh(S, *st, elem)) RefreshRow(S, *st);
+        if (elem >= S.rows.width) return kNone;
+        return ERF_StateElementMult{S.rows.gaugeAt(st->row)[elem], S.rows.healthAt(st->row)[elem]};
+    }
+
     namespace StatesSer {
         constexpr std::uint32_t kRecordID = FOURCC('E', 'S', 'T', 'S');
         constexpr std::uint32_t kVersion = 2;
     }
 
-    bool SaveStateHandles(SKSE::SerializationInterface* ser, const std::vector<ERF_StateHandle>& handles) {
-        return std::ranges::all_of(
-            handles, [ser](const auto& handle) { return ser->WriteRecordData(&handle, sizeof(ERF_StateHandle)); });
-    }
-
-    bool SaveActorStates(SKSE::SerializationInterface* ser, RE::FormID id, const PerActorStates& st) {
-        if (!ser->WriteRecordData(&id, sizeof(id))) return false;
+    bool SaveActorStates(SKSE::SerializationInterface* ser, const PerActorStates& st) {
+        if (!ser->WriteRecordData(&st.id, sizeof(st.id))) return false;
 
-        auto n = static_cast<std::uint16_t>(
-            std::min<std::size_t>(st.active.size(), std::numeric_limits<std::uint16_t>::max()));
+        const auto n = static_cast<std::uint16_t>(st.active.popcount());
         if (!ser->WriteRecordData(&n, sizeof(n))) return false;
 
-        if (n > 0) {
-            std::vector<ERF_StateHandle> tmp;
-            tmp.reserve(st.active.size());
-            for (auto sh : st.active) tmp.push_back(sh);
-            std::ranges::sort(tmp);
+        bool ok = true;
+        ForEachActive(st.active, [&](ERF_StateHandle sh) {
+            ok = ok && ser->WriteRecordData(&sh, sizeof(ERF_StateHandle));
+        });
+        return ok;
+    }
 
-            if (tmp.size() > n) {
-                tmp.resize(n);
-            }
+    // Actors whose form is gone or dead keep no states; evaluated outside the store lock.
+    bool ActorGone(RE::FormID id) {
+        const auto* a = RE::TESForm::LookupByID<RE::Actor>(id);
+        return !a || a->IsDead();
+    }
 
-            if (!SaveStateHandles(ser, tmp)) return false;
+    std::size_t CompactStore(Store& S) {
+        thread_local std::vector<RE::FormID> ids;
+        ids.clear();
+        {
+            std::shared_lock lk(S.lock);
+            S.table.forEach([](const PerActorStates& st) { ids.push_back(st.id); });
         }
-        return true;
+        std::erase_if(ids, [](RE::FormID id) { return !ActorGone(id); });
+        if (ids.empty()) return 0;
+
+        std::unique_lock lk(S.lock);
+        for (auto id : ids) {
+            if (auto* st = S.table.find(id)) {
+                ReleaseRow(S, *st);
+                S.table.erase(*st);
+            }
+        }
+        return ids.size();
     }
 
+    // Copied by the dry-run pass under the shared lock; the write pass serializes it without holding the lock.
+    std::vector<PerActorStates> g_saveSnapshot;
+
     bool Save(SKSE::SerializationInterface* ser, bool dryRun) {
+        auto& S = GetStore();
+
         if (dryRun) {
-            return !GetStore().empty();
+            CompactStore(S);
+            g_saveSnapshot.clear();
+            std::shared_lock lk(S.lock);
+            g_saveSnapshot.reserve(S.table.size());
+            S.table.forEach([](const PerActorStates& st) { g_saveSnapshot.push_back(st); });
+            return !g_saveSnapshot.empty();
         }
 
-        if (const auto countActors = static_cast<std::uint32_t>(GetStore().size());
+        if (const auto countActors = static_cast<std::uint32_t>(g_saveSnapshot.size());
             !ser->WriteRecordData(&countActors, sizeof(countActors)))
             return false;
 
-        for (const auto& [id, st] : GetStore()) {
-            if (!SaveActorStates(ser, id, st)) return false;
-        }
-
-        return true;
+        bool ok = true;
+        for (const auto& st : g_saveSnapshot) ok = ok && SaveActorStates(ser, st);
+        g_saveSnapshot.clear();
+        return ok;
     }
 
-    bool LoadStateHandles(SKSE::SerializationInterface* ser, std::unordered_set<ERF_StateHandle>& setRef,
-                          std::uint16_t n) {
+    bool LoadStateHandles(SKSE::SerializationInterface* ser, StateMask& mask, std::uint16_t n) {
+        const auto& remap = RegistrySchema::Active();
         for (std::uint16_t k = 0; k < n; ++k) {
             ERF_StateHandle sh{};
             if (!ser->ReadRecordData(&sh, sizeof(sh))) return false;
-            if (sh != 0) setRef.insert(sh);
+            sh = static_cast<ERF_StateHandle>(remap.toNew(RegistrySchema::Kind::kState, sh));
+            if (InRange(sh)) mask.set(sh - 1u);
         }
         return true;
     }
@@ -92,7 +376,7 @@ namespace {
 
     bool LoadActorState(SKSE::SerializationInterface* ser, RE::FormID oldID) {
         RE::FormID newID{};
-        if (!ser->ResolveFormID(oldID, newID)) {
+        if (!ser->ResolveFormID(oldID, newID) || newID == 0) {
             std::uint16_t n{};
             if (!ser->ReadRecordData(&n, sizeof(n))) return false;
             return SkipStateHandles(ser, n);
@@ -101,12 +385,27 @@ namespace {
         std::uint16_t n{};
         if (!ser->ReadRecordData(&n, sizeof(n))) return false;
 
-        auto& setRef = GetStore()[newID].active;
-        return LoadStateHandles(ser, setRef, n);
+        StateMask mask{};
+        if (!LoadStateHandles(ser, mask, n)) return false;
+        if (!mask.any()) return true;
+
+        auto& S = GetStore();
+        std::unique_lock lk(S.lock);
+        auto& st = S.table.insert(newID);
+        for (std::size_t w = 0; w < StateMask::kWords; ++w) st.active.w[w] |= mask.w[w];
+        st.rowGen = 0;
+        return true;
+    }
+
+    void ResetAll() {
+        auto& S = GetStore();
+        std::unique_lock lk(S.lock);
+        S.table.clear();
+        S.rows = MultRows{};
     }
 
     bool Load(SKSE::SerializationInterface* ser, std::uint32_t version, std::uint32_t) {
-        GetStore().clear();
+        ResetAll();
 
         if (version != StatesSer::kVersion) {
             return false;
@@ -125,109 +424,155 @@ namespace {
         return true;
     }
 
-    void Revert() { GetStore().clear(); }
+    void Revert() { ResetAll(); }
 }
 
 void ElementalStates::RegisterStore() {
     Ser::Register({StatesSer::kRecordID, StatesSer::kVersion, &Save, &Load, &Revert});
 }
 
+std::size_t ElementalStates::Compact() { return CompactStore(GetStore()); }
+
+void ElementalStates::SetElementMultipliers(ERF_StateHandle sh, ERF_ElementHandle elem, double gaugeMult,
+                                            double healthMult) {
+    auto& S = GetStore();
+    std::unique_lock lk(S.lock);
+    StateRegistry::get().setElementMultipliers(sh, elem, gaugeMult, healthMult);
+}
+
 bool ElementalStates::SetActive(RE::Actor* a, ERF_StateHandle sh, bool value) {
     if (!a || sh == 0) return false;
     const auto id = IdOf(a);
     if (id == 0) return false;
-    auto& st = GetStore()[id].active;
-    if (value) {
-        st.insert(sh);
-    } else {
-        st.erase(sh);
+    if (!InRange(sh)) {
+        WarnOutOfRange(sh);
+        return false;
     }
+
+    bool gaugeChanged = false;
+    {
+        auto& S = GetStore();
+        std::unique_lock lk(S.lock);
+        auto next = StateMask{};
+        if (const auto* st = S.table.find(id)) next = st->active;
+        if (value) {
+            next.set(sh - 1u);
+        } else {
+            next.reset(sh - 1u);
+        }
+        gaugeChanged = ReplaceMask(S, id, next);
+    }
+    if (gaugeChanged) ElementalGauges::InvalidateStateMultipliers(a);
     return true;
 }
 
-bool ElementalStates::IsActive(RE::Actor* a, ERF_StateHandle sh) {
-    if (!a || sh == 0) return false;
+bool ElementalStates::SetStates(RE::Actor* a, std::span<const ERF_StateHandle> states) {
+    if (!a) return false;
     const auto id = IdOf(a);
-    auto it = GetStore().find(id);
-    if (it == GetStore().end()) return false;
-    return it->second.active.contains(sh);
+    if (id == 0) return false;
+
+    StateMask next{};
+    if (const auto dropped = MaskFrom(states, next)) WarnOutOfRange(dropped);
+
+    bool gaugeChanged = false;
+    {
+        auto& S = GetStore();
+        std::unique_lock lk(S.lock);
+        gaugeChanged = ReplaceMask(S, id, next);
+    }
+    if (gaugeChanged) ElementalGauges::InvalidateStateMultipliers(a);
+    return true;
 }
 
-void ElementalStates::Activate(RE::Actor* a, ERF_StateHandle sh) {
-    (void)SetActive(a, sh, true);
-    ElementalGauges::InvalidateStateMultipliers(a);
+std::uint32_t ElementalStates::SetStateFor(std::span<RE::Actor* const> actors, ERF_StateHandle sh, bool value) {
+    if (actors.empty() || sh == 0) return 0;
+    if (!InRange(sh)) {
+        WarnOutOfRange(sh);
+        return 0;
+    }
+
+    thread_local std::vector<RE::Actor*> invalidate;
+    invalidate.clear();
+    std::uint32_t changed = 0;
+    {
+        auto& S = GetStore();
+        std::unique_lock lk(S.lock);
+        for (auto* a : actors) {
+            const auto id = IdOf(a);
+            if (id == 0) continue;
+
+            auto next = StateMask{};
+            if (const auto* st = S.table.find(id)) next = st->active;
+            if (next.test(sh - 1u) == value) continue;
+            if (value) {
+                next.set(sh - 1u);
+            } else {
+                next.reset(sh - 1u);
+            }
+
+            ++changed;
+            if (ReplaceMask(S, id, next)) invalidate.push_back(a);
+        }
+    }
+    for (auto* a : invalidate) ElementalGauges::InvalidateStateMultipliers(a);
+    return changed;
 }
 
-void ElementalStates::Deactivate(RE::Actor* a, ERF_StateHandle sh) {
-    (void)SetActive(a, sh, false);
-    ElementalGauges::InvalidateStateMultipliers(a);
+bool ElementalStates::IsActive(RE::Actor* a, ERF_StateHandle sh) {
+    if (!a || !InRange(sh)) return false;
+    auto& S = GetStore();
+    std::shared_lock lk(S.lock);
+    const auto* st = S.table.find(IdOf(a));
+    return st && st->active.test(sh - 1u);
 }
 
+void ElementalStates::Activate(RE::Actor* a, ERF_StateHandle sh) { (void)SetActive(a, sh, true); }
+
+void ElementalStates::Deactivate(RE::Actor* a, ERF_StateHandle sh) { (void)SetActive(a, sh, false); }
+
 void ElementalStates::Clear(RE::Actor* a) {
     if (!a) return;
-    const auto id = IdOf(a);
-    GetStore().erase(id);
+    auto& S = GetStore();
+    std::unique_lock lk(S.lock);
+    if (auto* st = S.table.find(IdOf(a))) {
+        ReleaseRow(S, *st);
+        S.table.erase(*st);
+    }
 }
 
-void ElementalStates::ClearAll() { GetStore().clear(); }
+void ElementalStates::ClearAll() { ResetAll(); }
 
 std::vector<ERF_StateHandle> ElementalStates::GetActive(RE::Actor* a) {
     std::vector<ERF_StateHandle> out;
     if (!a) return out;
-    const auto id = IdOf(a);
-    auto it = GetStore().find(id);
-    if (it == GetStore().end()) return out;
-    out.reserve(it->second.active.size());
-    for (auto sh : it->second.active) out.push_back(sh);
+    auto& S = GetStore();
+    std::shared_lock lk(S.lock);
+    const auto* st = S.table.find(IdOf(a));
+    if (!st) return out;
+    out.reserve(static_cast<std::size_t>(st->active.popcount()));
+    ForEachActive(st->active, [&](ERF_StateHandle sh) { out.push_back(sh); });
     return out;
 }
 
 double ElementalStates::GetGaugeMultiplierFor(RE::Actor* a, ERF_ElementHandle elem) {
-    if (!a || elem == 0) {
-        return 1.0;
-    }
-
-    const auto active = GetActive(a);
-    if (active.empty()) {
-        return 1.0;
-    }
-
-    auto const& SR = StateRegistry::get();
-    double mult = 1.0;
-
-    const auto elemHandle = elem;
-
-    for (ERF_StateHandle sh : active) {
-        if (sh == 0) {
-            continue;
-        }
-        mult *= SR.getGaugeMultiplier(sh, elemHandle);
-    }
-
-    return mult;
+    return MultipliersFor(a, elem).gaugeMult;
 }
 
 double ElementalStates::GetHealthMultiplierFor(RE::Actor* a, ERF_ElementHandle elem) {
-    if (!a || elem == 0) {
-        return 1.0;
-    }
-
-    const auto active = GetActive(a);
-    if (active.empty()) {
-        return 1.0;
-    }
-
-    auto const& SR = StateRegistry::get();
-    double mult = 1.0;
+    return MultipliersFor(a, elem).healthMult;
+}
 
-    const auto elemHandle = elem;
+void ElementalStates::FillGaugeMultipliers(RE::Actor* a, std::span<double> out) {
+    FillGaugeMultipliers(IdOf(a), out);
+}
 
-    for (ERF_StateHandle sh : active) {
-        if (sh == 0) {
-            continue;
-        }
-        mult *= SR.getHealthMultiplier(sh, elemHandle);
-    }
+void ElementalStates::FillGaugeMultipliers(RE::FormID id, std::span<double> out) {
+    std::ranges::fill(out, 1.0);
+    if (id == 0) return;
 
-    return mult;
-}
\ No newline at end of file
+    auto& S = GetStore();
+    std::shared_lock lk(S.lock);
+    const auto row = FreshGaugeRow(S, id, lk);
+    const std::size_t n = std::min(out.size(), row.size());
+    for (std::size_t i = 1; i < n; ++i) out[i] = row[i];
+}
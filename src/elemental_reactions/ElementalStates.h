@@ -1,6 +1,5 @@
 #pragma once
-#include <unordered_map>
-#include <unordered_set>
+#include <span>
 #include <vector>
 
 #include "RE/Skyrim.h"
@@ -10,7 +9,16 @@
 namespace ElementalStates {
     void RegisterStore();
 
+    // Drops the states of actors that are dead or no longer resolve; returns how many were dropped.
+    std::size_t Compact();
+
+    // Writes the registry's state x element multipliers under the store lock, so a row refresh never reads a
+    // half-written matrix.
+    void SetElementMultipliers(ERF_StateHandle sh, ERF_ElementHandle elem, double gaugeMult, double healthMult);
+
     bool SetActive(RE::Actor* a, ERF_StateHandle sh, bool value);
+    bool SetStates(RE::Actor* a, std::span<const ERF_StateHandle> states);
+    std::uint32_t SetStateFor(std::span<RE::Actor* const> actors, ERF_StateHandle sh, bool value);
     bool IsActive(RE::Actor* a, ERF_StateHandle sh);
 
     void Activate(RE::Actor* a, ERF_StateHandle sh);
@@ -24,4 +32,8 @@ namespace ElementalStates {
     double GetGaugeMultiplierFor(RE::Actor* a, ERF_ElementHandle elem);
 
     double GetHealthMultiplierFor(RE::Actor* a, ERF_ElementHandle elem);
+
+    // out[elem] = product of the gauge multipliers of every active state; 1.0 where none apply.
+    void FillGaugeMultipliers(RE::Actor* a, std::span<double> out);
+    void FillGaugeMultipliers(RE::FormID id, std::span<double> out);
 }
\ No newline at end of file
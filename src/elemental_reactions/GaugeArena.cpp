@@ -0,0 +1,110 @@
+#include "GaugeArena.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "erf_element.h"
+
+namespace {
+    constexpr std::size_t alignUp(std::size_t v, std::size_t a) { return (v + a - 1) & ~(a - 1); }
+
+    template <class T>
+    std::size_t place(std::size_t& cursor, std::size_t count) {
+        cursor = alignUp(cursor, alignof(T));
+        const std::size_t off = cursor;
+        cursor += count * sizeof(T);
+        return off;
+    }
+}
+
+Gauges::SlotLayout Gauges::SlotLayout::Make(std::size_t nE, std::size_t nR, std::size_t nP) {
+    SlotLayout L{};
+    L.nE = nE;
+    L.nR = nR;
+    L.nP = nP;
+    L.nMaskWords = (nE + 63) / 64;
+
+    std::size_t cur = 0;
+
+    L.offPresentMask = place<std::uint64_t>(cur, L.nMaskWords);
+    L.offBlockUntilRtS = place<double>(cur, nE);
+    L.offEffMult = place<double>(cur, nE);
+    L.offReactCdRtS = place<double>(cur, nR);
+    L.offPreExpireRtS = place<double>(cur, nP);
+
+    L.offLastHitH = place<float>(cur, nE);
+    L.offLastEvalH = place<float>(cur, nE);
+    L.offBlockUntilH = place<float>(cur, nE);
+    L.offReactCdH = place<float>(cur, nR);
+    L.offPreIntensity = place<float>(cur, nP);
+    L.offPreExpireH = place<float>(cur, nP);
+
+    L.offPosInList = place<std::uint16_t>(cur, nE);
+    L.offPresentList = place<ERF_ElementHandle>(cur, nE);
+
+    L.offV = place<std::uint8_t>(cur, nE);
+    L.offInReaction = place<std::uint8_t>(cur, nR);
+    L.offPreActive = place<std::uint8_t>(cur, nP);
+
+    L.stride = alignUp(std::max<std::size_t>(cur, 1), Arena::kSlotAlign);
+    return L;
+}
+
+void Gauges::Arena::configure(std::size_t nE, std::size_t nR, std::size_t nP, std::uint32_t initialSlots) {
+    _chunks.clear();
+    _free.clear();
+    _live = 0;
+    _layout = SlotLayout::Make(nE, nR, nP);
+
+    const std::uint32_t want = std::max<std::uint32_t>(initialSlots, 1);
+    while (capacity() < want) addChunk();
+    reset();
+}
+
+void Gauges::Arena::addChunk() {
+    const std::size_t bytes = _layout.stride * kSlotsPerChunk;
+    _chunks.emplace_back(static_cast<std::byte*>(::operator new[](bytes, std::align_val_t{kSlotAlign})));
+
+    const auto first = static_cast<std::uint32_t>(_chunks.size() - 1) * kSlotsPerChunk;
+    _free.reserve(_free.size() + kSlotsPerChunk);
+    for (std::uint32_t i = kSlotsPerChunk; i-- > 0;) {
+        _free.push_back(first + i);
+    }
+}
+
+void Gauges::Arena::initSlot(std::uint32_t slot) const noexcept {
+    std::byte* base = slotBase(slot);
+    std::memset(base, 0, _layout.stride);
+
+    auto eff = view<double>(slot, _layout.offEffMult, _layout.nE);
+    std::ranges::fill(eff, 1.0);
+
+    auto pos = view<std::uint16_t>(slot, _layout.offPosInList, _layout.nE);
+    std::ranges::fill(pos, std::uint16_t{0xFFFF});
+}
+
+std::uint32_t Gauges::Arena::acquire() {
+    if (!configured()) return kNoSlot;
+    if (_free.empty()) addChunk();
+
+    const std::uint32_t slot = _free.back();
+    _free.pop_back();
+    initSlot(slot);
+    ++_live;
+    return slot;
+}
+
+void Gauges::Arena::release(std::uint32_t slot) {
+    if (slot == kNoSlot || slot >= capacity()) return;
+    _free.push_back(slot);
+    if (_live) --_live;
+}
+
+void Gauges::Arena::reset() {
+    _free.clear();
+    _live = 0;
+    _free.reserve(capacity());
+    for (std::uint32_t i = capacity(); i-- > 0;) {
+        _free.push_back(i);
+    }
+}
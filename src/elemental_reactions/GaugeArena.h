@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <vector>
+
+namespace Gauges {
+    struct SlotLayout {
+        std::size_t nE{0};
+        std::size_t nR{0};
+        std::size_t nP{0};
+        std::size_t nMaskWords{0};
+
+        std::size_t offPresentMask{0};
+        std::size_t offBlockUntilRtS{0};
+        std::size_t offEffMult{0};
+        std::size_t offReactCdRtS{0};
+        std::size_t offPreExpireRtS{0};
+
+        std::size_t offLastHitH{0};
+        std::size_t offLastEvalH{0};
+        std::size_t offBlockUntilH{0};
+        std::size_t offReactCdH{0};
+        std::size_t offPreIntensity{0};
+        std::size_t offPreExpireH{0};
+
+        std::size_t offPosInList{0};
+        std::size_t offPresentList{0};
+
+        std::size_t offV{0};
+        std::size_t offInReaction{0};
+        std::size_t offPreActive{0};
+
+        std::size_t stride{0};
+
+        static SlotLayout Make(std::size_t nE, std::size_t nR, std::size_t nP);
+    };
+
+    class Arena {
+    public:
+        static constexpr std::uint32_t kNoSlot = 0xFFFFFFFFu;
+        static constexpr std::size_t kSlotAlign = 64;
+        static constexpr std::uint32_t kSlotsPerChunk = 256;
+
+        void configure(std::size_t nE, std::size_t nR, std::size_t nP, std::uint32_t initialSlots);
+        bool configured() const noexcept { return _layout.stride != 0; }
+        const SlotLayout& layout() const noexcept { return _layout; }
+
+        std::uint32_t acquire();
+        void release(std::uint32_t slot);
+        void reset();
+
+        std::uint32_t liveSlots() const noexcept { return _live; }
+        std::uint32_t capacity() const noexcept { return static_cast<std::uint32_t>(_chunks.size()) * kSlotsPerChunk; }
+        std::size_t bytesReserved() const noexcept { return _chunks.size() * _layout.stride * kSlotsPerChunk; }
+
+        template <class T>
+        std::span<T> view(std::uint32_t slot, std::size_t offset, std::size_t count) const noexcept {
+            return {reinterpret_cast<T*>(slotBase(slot) + offset), count};
+        }
+
+    private:
+        struct AlignedFree {
+            void operator()(std::byte* p) const noexcept { ::operator delete[](p, std::align_val_t{kSlotAlign}); }
+        };
+        using Chunk = std::unique_ptr<std::byte[], AlignedFree>;
+
+        std::byte* slotBase(std::uint32_t slot) const noexcept {
+            return _chunks[slot / kSlotsPerChunk].get() + static_cast<std::size_t>(slot % kSlotsPerChunk) * _layout.stride;
+        }
+        void addChunk();
+        void initSlot(std::uint32_t slot) const noexcept;
+
+        SlotLayout _layout{};
+        std::vector<Chunk> _chunks;
+        std::vector<std::uint32_t> _free;
+        std::uint32_t _live{0};
+    };
+}
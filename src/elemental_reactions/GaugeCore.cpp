@@ -0,0 +1,649 @@
+#include "GaugeCore.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace Gauges {
+    namespace {
+        Host g_host;
+
+        Arena& arena() {
+            auto& A = store().arena;
+            if (!A.configured()) {
+                if (g_host.freeze) g_host.freeze();
+                const std::size_t nE = ElementRegistry::get().size() + 1;
+                const std::size_t nR = ReactionRegistry::get().size() + 1;
+                const std::size_t nP = PreEffectRegistry::get().size() + 1;
+                A.configure(nE, nR, nP, 512);
+            }
+            return A;
+        }
+
+        void bindEntry(Entry& e, std::uint32_t slot) {
+            const auto& A = arena();
+            const auto& L = A.layout();
+
+            e.slot = slot;
+
+            e.v = A.view<std::uint8_t>(slot, L.offV, L.nE);
+            e.lastHitH = A.view<float>(slot, L.offLastHitH, L.nE);
+            e.lastEvalH = A.view<float>(slot, L.offLastEvalH, L.nE);
+            e.blockUntilH = A.view<float>(slot, L.offBlockUntilH, L.nE);
+            e.blockUntilRtS = A.view<double>(slot, L.offBlockUntilRtS, L.nE);
+            e.effMult = A.view<double>(slot, L.offEffMult, L.nE);
+            e.posInList = A.view<std::uint16_t>(slot, L.offPosInList, L.nE);
+
+            e.reactCdRtS = A.view<double>(slot, L.offReactCdRtS, L.nR);
+            e.reactCdH = A.view<float>(slot, L.offReactCdH, L.nR);
+            e.inReaction = A.view<std::uint8_t>(slot, L.offInReaction, L.nR);
+
+            e.preActive = A.view<std::uint8_t>(slot, L.offPreActive, L.nP);
+            e.preIntensity = A.view<float>(slot, L.offPreIntensity, L.nP);
+            e.preExpireRtS = A.view<double>(slot, L.offPreExpireRtS, L.nP);
+            e.preExpireH = A.view<float>(slot, L.offPreExpireH, L.nP);
+
+            e.presentList.items = A.view<ERF_ElementHandle>(slot, L.offPresentList, L.nE).data();
+            e.presentList.count = 0;
+            e.presentMask = A.view<std::uint64_t>(slot, L.offPresentMask, L.nMaskWords);
+            e.sumAll = 0;
+            e.sumMix = 0;
+            e.effDirty = true;
+
+            e.holdUntilRtS = 0.0;
+            e.holdUntilH = 0.f;
+            e.drainWakeH = 0.f;
+            e.inReactionCount = 0;
+            touch(e);
+        }
+
+        void makePresent(Entry& e, std::size_t i) {
+            if (i < firstIndex()) return;
+            if (i >= e.posInList.size()) return;
+            if (e.posInList[i] != 0xFFFF) return;
+            const ERF_ElementHandle h = handleFromIndex(i);
+
+            if (const auto bit = static_cast<std::size_t>(h - 1); (bit >> 6) < e.presentMask.size()) {
+                e.presentMask[bit >> 6] |= (UINT64_C(1) << (bit & 63));
+            }
+            e.posInList[i] = static_cast<std::uint16_t>(e.presentList.size());
+            e.presentList.push_back(h);
+        }
+
+        void dropPresent(Entry& e, std::size_t i) {
+            if (i < firstIndex()) return;
+            if (i >= e.posInList.size()) return;
+            auto pos = e.posInList[i];
+            if (pos == 0xFFFF) return;
+            const auto lastIdx = static_cast<std::uint16_t>(e.presentList.size() - 1);
+            const ERF_ElementHandle h = handleFromIndex(i);
+
+            if (const auto bit = static_cast<std::size_t>(h - 1); (bit >> 6) < e.presentMask.size()) {
+                e.presentMask[bit >> 6] &= ~(UINT64_C(1) << (bit & 63));
+            }
+            if (pos != lastIdx) {
+                const ERF_ElementHandle lastH = e.presentList[lastIdx];
+                e.presentList[pos] = lastH;
+                const std::size_t lastI = idx(lastH);
+                if (lastI < e.posInList.size()) e.posInList[lastI] = pos;
+            }
+            e.presentList.pop_back();
+            e.posInList[i] = 0xFFFF;
+        }
+
+        // Deadlines are scheduled at ceil(due) and the wheels advance to floor(now), so a wake never fires early.
+        std::uint64_t dueTick(double t, double perUnit) {
+            return t <= 0.0 ? 0 : static_cast<std::uint64_t>(std::ceil(t * perUnit));
+        }
+        std::uint64_t nowTick(double t, double perUnit) {
+            return t <= 0.0 ? 0 : static_cast<std::uint64_t>(std::floor(t * perUnit));
+        }
+
+        void holdRt(Entry& e, RE::FormID id, double untilRt) {
+            if (untilRt <= e.holdUntilRtS) return;
+            e.holdUntilRtS = untilRt;
+            store().rtWheel.schedule(dueTick(untilRt, kRtTicksPerSec), id);
+        }
+        void holdH(Entry& e, RE::FormID id, float untilH) {
+            if (untilH <= e.holdUntilH) return;
+            e.holdUntilH = untilH;
+            store().hourWheel.schedule(dueTick(untilH, kHourTicksPerHour), id);
+        }
+    }
+
+    void Bind(const Host& host) { g_host = host; }
+    const Host& host() noexcept { return g_host; }
+
+    float drainAtH(const Entry& e, const DecaySnapshot& snap) {
+        if (snap.ratePerHour <= 0.f) return std::numeric_limits<float>::infinity();
+        float at = 0.f;
+        for (ERF_ElementHandle h : e.presentList) {
+            const std::size_t i = idx(h);
+            const float startH = std::max(e.lastEvalH[i], e.lastHitH[i] + snap.graceHours);
+            at = std::max(at, startH + static_cast<float>(e.v[i]) / snap.ratePerHour);
+        }
+        return at;
+    }
+
+    DecaySnapshot SnapshotDecay() {
+        const float ts = g_host.clock->timescale();
+        DecaySnapshot s{kRealDecayPerSec * 3600.0f / ts, (kGraceSec * ts) / 3600.0f};
+        return s;
+    }
+
+    std::pair<Map::iterator, bool> acquire(RE::FormID id) {
+        auto& M = state();
+        auto [it, inserted] = M.try_emplace(id);
+        if (inserted) bindEntry(it->second, arena().acquire());
+        return {it, inserted};
+    }
+
+    Map::iterator erase(Map::iterator it) {
+        store().arena.release(it->second.slot);
+        return state().erase(it);
+    }
+
+    void erase(RE::FormID id) {
+        auto& M = state();
+        if (auto it = M.find(id); it != M.end()) erase(it);
+    }
+
+    void clearAll() {
+        auto& S = store();
+        S.map.clear();
+        S.arena.reset();
+        S.rtWheel.clear();
+        S.hourWheel.clear();
+    }
+
+    void onValChange(Entry& e, std::size_t i, int before, int after) {
+        if (i < firstIndex()) return;
+        if (before != after) touch(e);
+
+        const int delta = after - before;
+
+        e.sumAll += delta;
+        if (e.sumAll < 0) e.sumAll = 0;
+
+        if (delta != 0) {
+            const ERF_ElementHandle h = handleFromIndex(i);
+            if (h != 0) {
+                auto const& ER = ElementRegistry::get();
+                if (const ERF_ElementDesc* d = ER.get(h)) {
+                    if (!d->noMixInMixedMode) {
+                        e.sumMix += delta;
+                        if (e.sumMix < 0) e.sumMix = 0;
+                    }
+                } else {
+                    e.sumMix += delta;
+                    if (e.sumMix < 0) e.sumMix = 0;
+                }
+            }
+        }
+
+        const bool was = (before > 0);
+        const bool is = (after > 0);
+        if (was == is) return;
+        if (is)
+            makePresent(e, i);
+        else
+            dropPresent(e, i);
+    }
+
+    void tickOne(Entry& e, std::size_t i, float nowH, const DecaySnapshot& snap) {
+        auto& val = e.v[i];
+        auto& eval = e.lastEvalH[i];
+        const float hit = e.lastHitH[i];
+
+        if (val == 0) {
+            eval = nowH;
+            return;
+        }
+
+        const float rate = snap.ratePerHour;
+        if (rate <= 0.f) {
+            eval = nowH;
+            return;
+        }
+
+        const float graceEnd = hit + snap.graceHours;
+        if (nowH <= graceEnd) return;
+
+        const float startH = std::max(eval, graceEnd);
+        const float elapsedH = nowH - startH;
+        if (elapsedH <= 0.f) return;
+
+        const float decF = elapsedH * rate;
+        const auto before = static_cast<int>(val);
+
+        if (decF >= static_cast<float>(before)) {
+            val = 0;
+            onValChange(e, i, before, 0);
+            eval = nowH;
+            return;
+        }
+
+        const auto decI = static_cast<int>(decF);
+        if (decI <= 0) return;
+
+        int next = before - decI;
+        if (next < 0) next = 0;
+        val = static_cast<std::uint8_t>(next);
+        if (next != before) onValChange(e, i, before, next);
+
+        const float rem = decF - static_cast<float>(decI);
+        eval = nowH - (rem / rate);
+    }
+
+    void tickPresent(Entry& e, float nowH, const DecaySnapshot& snap) {
+        for (std::size_t k = e.presentList.size(); k-- > 0;) {
+            tickOne(e, idx(e.presentList[k]), nowH, snap);
+        }
+    }
+
+    void queueDrainWake(Entry& e, RE::FormID id, const DecaySnapshot& snap) {
+        if (e.drainWakeH > 0.f || e.sumAll <= 0) return;
+        const float at = drainAtH(e, snap);
+        if (!std::isfinite(at)) return;
+        e.drainWakeH = at;
+        store().hourWheel.schedule(dueTick(at, kHourTicksPerHour), id);
+    }
+
+    void scheduleLoadedHolds(Entry& e, RE::FormID id) {
+        double rt = 0.0;
+        float h = 0.f;
+        for (std::size_t i = firstIndex(); i < e.v.size(); ++i) {
+            rt = std::max(rt, e.blockUntilRtS[i]);
+            h = std::max(h, e.blockUntilH[i]);
+        }
+        for (std::size_t ri = firstIndex(); ri < e.reactCdRtS.size(); ++ri) {
+            rt = std::max(rt, e.reactCdRtS[ri]);
+            h = std::max(h, e.reactCdH[ri]);
+            if (e.inReaction[ri] != 0) ++e.inReactionCount;
+        }
+        for (std::size_t pi = firstIndex(); pi < e.preActive.size(); ++pi) {
+            if (!e.preActive[pi]) continue;
+            rt = std::max(rt, e.preExpireRtS[pi]);
+            h = std::max(h, e.preExpireH[pi]);
+        }
+        holdRt(e, id, rt);
+        holdH(e, id, h);
+    }
+
+    void pumpDeadlines(double nowRt, float nowH, const DecaySnapshot& snap) {
+        auto& S = store();
+        auto wake = [&](RE::FormID id) {
+            auto it = S.map.find(id);
+            if (it == S.map.end()) return;
+            auto& e = it->second;
+            tickPresent(e, nowH, snap);
+            if (idle(e, nowRt, nowH)) {
+                erase(it);
+                return;
+            }
+            queueDrainWake(e, id, snap);
+        };
+
+        S.rtWheel.advance(nowTick(nowRt, kRtTicksPerSec), wake);
+        S.hourWheel.advance(nowTick(nowH, kHourTicksPerHour), [&](RE::FormID id) {
+            if (auto it = S.map.find(id); it != S.map.end()) it->second.drainWakeH = 0.f;
+            wake(id);
+        });
+    }
+
+    std::size_t compact(double nowRt, float nowH, const DecaySnapshot& snap) {
+        pumpDeadlines(nowRt, nowH, snap);
+        std::size_t dropped = 0;
+        auto& M = state();
+        for (auto it = M.begin(); it != M.end();) {
+            auto& e = it->second;
+            tickPresent(e, nowH, snap);
+            if (idle(e, nowRt, nowH) || g_host.actors->isGone(it->first)) {
+                it = erase(it);
+                ++dropped;
+            } else {
+                ++it;
+            }
+        }
+        return dropped;
+    }
+
+    void rebuildPresence(Entry& e) {
+        std::ranges::fill(e.presentMask, std::uint64_t{0});
+        e.presentList.clear();
+        e.sumAll = 0;
+        e.sumMix = 0;
+        std::ranges::fill(e.posInList, std::uint16_t{0xFFFF});
+
+        auto const& ER = ElementRegistry::get();
+
+        for (std::size_t i = firstIndex(); i < e.v.size(); ++i) {
+            const int v = e.v[i];
+            if (v > 0) {
+                e.sumAll += v;
+
+                const ERF_ElementHandle h = handleFromIndex(i);
+                if (const ERF_ElementDesc* d = ER.get(h); !d || !d->noMixInMixedMode) {
+                    e.sumMix += v;
+                }
+
+                makePresent(e, i);
+            }
+        }
+        touch(e);
+    }
+
+    namespace {
+        void ApplyElementLocksForReaction(RE::FormID id, Entry& e, const std::vector<ERF_ElementHandle>& elems,
+                                          float seconds) {
+            if (seconds <= 0.f) return;
+
+            const double untilRt = g_host.clock->nowRt() + seconds;
+
+            for (ERF_ElementHandle h : elems) {
+                const std::size_t i = idx(h);
+                if (i >= e.v.size()) continue;
+                e.blockUntilRtS[i] = std::max(e.blockUntilRtS[i], untilRt);
+            }
+            holdRt(e, id, untilRt);
+        }
+
+        void SetReactionCooldown(RE::FormID id, Entry& e, ERF_ReactionHandle rh, float cooldownSeconds) {
+            if (cooldownSeconds <= 0.f || rh == 0) return;
+
+            const std::size_t ri = idxReact(rh);
+
+            const double untilRt = g_host.clock->nowRt() + static_cast<double>(cooldownSeconds);
+            if (ri < e.reactCdRtS.size()) e.reactCdRtS[ri] = std::max(e.reactCdRtS[ri], untilRt);
+            holdRt(e, id, untilRt);
+        }
+
+        // Lockouts, cooldown, HUD/trace notification and the deferred callback of one picked reaction.
+        void FireReaction(RE::FormID id, Entry& e, ERF_ReactionHandle rh, const ERF_ReactionDesc& r, float nowH) {
+            ApplyElementLocksForReaction(id, e, r.elements, r.elementLockoutSeconds);
+            SetReactionCooldown(id, e, rh, r.cooldownSeconds);
+
+            const float durS =
+                (r.elementLockoutSeconds > 0.f) ? r.elementLockoutSeconds : std::max(0.5f, r.cooldownSeconds);
+            g_host.events->reaction(id, rh, durS, g_host.clock->nowRt(), nowH);
+
+            if (r.cb) g_host.tasks->reaction(id, r.cb, r.user);
+        }
+
+        void ClearElement(Entry& e, std::size_t i, float nowH) {
+            const int before = e.v[i];
+            e.v[i] = 0;
+            e.lastHitH[i] = nowH;
+            e.lastEvalH[i] = nowH;
+            onValChange(e, i, before, 0);
+        }
+
+        // Clears every mixable element; returns whether any held a value.
+        bool ClearMixable(Entry& e, float nowH) {
+            auto const& ER = ElementRegistry::get();
+            bool clearedAny = false;
+            for (std::size_t i = firstIndex(); i < e.v.size(); ++i) {
+                if (!e.v[i]) continue;
+                if (const ERF_ElementDesc* d = ER.get(handleFromIndex(i)); d && d->noMixInMixedMode) continue;
+                ClearElement(e, i, nowH);
+                clearedAny = true;
+            }
+            return clearedAny;
+        }
+
+        // elem == 0 picks over the mixable elements; otherwise over that element alone. The picked elements are
+        // consumed once, before the first reaction fires; a threshold crossing with no matching reaction still
+        // clears them.
+        bool TriggerReaction(RE::FormID id, Entry& e, ERF_ElementHandle elem) {
+            if (e.sumAll <= 0) {
+                return false;
+            }
+
+            auto const& RR = ReactionRegistry::get();
+
+            int maxCount = g_host.tuning->maxReactionsPerTrigger;
+            if (maxCount < 1) {
+                maxCount = 1;
+            }
+
+            std::vector<ERF_PickBestInfo> picks;
+            picks.reserve(static_cast<std::size_t>(maxCount));
+
+            std::vector<std::uint8_t> totals(e.v.size(), 0);
+            std::vector<ERF_ElementHandle> present;
+            int sum = 0;
+
+            if (elem == 0) {
+                sum = e.sumMix;
+                if (sum <= 0) {
+                    return false;
+                }
+
+                auto const& ER = ElementRegistry::get();
+                present.reserve(e.presentList.size());
+
+                for (ERF_ElementHandle h : e.presentList) {
+                    if (const ERF_ElementDesc* d = ER.get(h); d && d->noMixInMixedMode) {
+                        continue;
+                    }
+
+                    const std::size_t i = idx(h);
+                    if (i >= e.v.size()) {
+                        continue;
+                    }
+
+                    const std::uint8_t v = e.v[i];
+                    if (!v) {
+                        continue;
+                    }
+
+                    totals[i] = v;
+                    present.push_back(h);
+                }
+
+                if (present.empty()) {
+                    return false;
+                }
+            } else {
+                const std::size_t i = idx(elem);
+                sum = (i < e.v.size()) ? static_cast<int>(e.v[i]) : 0;
+                if (sum <= 0) {
+                    return false;
+                }
+                totals[i] = static_cast<std::uint8_t>(sum);
+                present.push_back(elem);
+            }
+
+            const float invSum = 1.0f / static_cast<float>(sum);
+            RR.pickBestFastMulti(totals, std::span<const ERF_ElementHandle>(present.data(), present.size()), sum,
+                                 invSum, maxCount, picks);
+
+            const float nowH = g_host.clock->nowH();
+
+            if (picks.empty()) {
+                if (elem == 0) return ClearMixable(e, nowH);
+                ClearElement(e, idx(elem), nowH);
+                return true;
+            }
+
+            bool cleared = false;
+            bool any = false;
+
+            for (const auto& info : picks) {
+                const ERF_ReactionHandle rh = info.handle;
+                if (!rh) {
+                    continue;
+                }
+
+                const ERF_ReactionDesc* r = RR.get(rh);
+                if (!r) {
+                    continue;
+                }
+
+                if (!cleared) {
+                    if (elem == 0)
+                        ClearMixable(e, nowH);
+                    else
+                        ClearElement(e, idx(elem), nowH);
+                    cleared = true;
+                }
+
+                FireReaction(id, e, rh, *r, nowH);
+                any = true;
+            }
+
+            return any;
+        }
+
+        bool MaybeTriggerPreEffectsFor(RE::FormID id, Entry& e, ERF_ElementHandle elem, std::uint8_t gaugeNow) {
+            if (elem == 0) return false;
+
+            const auto& PR = PreEffectRegistry::get();
+            const auto list = PR.listByElement(elem);
+            if (list.empty()) return false;
+
+            const double nowRt = g_host.clock->nowRt();
+            const float nowH = g_host.clock->nowH();
+
+            bool any = false;
+
+            for (auto ph : list) {
+                const auto* pd = PR.get(ph);
+                if (!pd || pd->element != elem) continue;
+
+                const std::size_t pi = idxPre(ph);
+                if (pi >= e.preActive.size()) continue;
+
+                if (const bool above = (gaugeNow >= pd->minGauge); !above) {
+                    if (e.preActive[pi]) {
+                        e.preActive[pi] = 0u;
+                        e.preIntensity[pi] = 0.f;
+                        e.preExpireRtS[pi] = 0.0;
+                        e.preExpireH[pi] = 0.f;
+
+                        if (pd->cb) g_host.tasks->preEffect(id, pd->cb, elem, gaugeNow, 0.0f, pd->user);
+                        any = true;
+                    }
+                    continue;
+                }
+
+                float intensity = pd->baseIntensity + pd->scalePerPoint * static_cast<float>(gaugeNow - pd->minGauge);
+                if (intensity < pd->minIntensity) intensity = pd->minIntensity;
+                if (intensity > pd->maxIntensity) intensity = pd->maxIntensity;
+
+                bool needApply = false;
+
+                if (!e.preActive[pi]) {
+                    needApply = true;
+                } else {
+                    if (const float last = e.preIntensity[pi]; std::fabs(last - intensity) > 1e-3f) {
+                        needApply = true;
+                    }
+
+                    if (!needApply && pd->durationSeconds > 0.0f) {
+                        constexpr double marginRt = 0.20;
+                        constexpr float marginH = 0.20f / 3600.0f;
+                        if (pd->durationIsRealTime) {
+                            if (nowRt + marginRt >= e.preExpireRtS[pi]) needApply = true;
+                        } else {
+                            if (nowH + marginH >= e.preExpireH[pi]) needApply = true;
+                        }
+                    }
+                }
+
+                if (!needApply) continue;
+
+                if (pd->cb) g_host.tasks->preEffect(id, pd->cb, elem, gaugeNow, intensity, pd->user);
+
+                e.preActive[pi] = 1u;
+                e.preIntensity[pi] = intensity;
+
+                if (pd->durationSeconds > 0.0f) {
+                    if (pd->durationIsRealTime) {
+                        const double untilRt = nowRt + static_cast<double>(pd->durationSeconds);
+                        e.preExpireRtS[pi] = std::max(e.preExpireRtS[pi], untilRt);
+                        holdRt(e, id, untilRt);
+                    } else {
+                        const float untilH = nowH + static_cast<float>(pd->durationSeconds / 3600.0);
+                        e.preExpireH[pi] = std::max(e.preExpireH[pi], untilH);
+                        holdH(e, id, untilH);
+                    }
+                }
+
+                any = true;
+            }
+
+            return any;
+        }
+
+        void RecomputeEffMultipliers(RE::FormID id, Entry& e) {
+            const auto n = e.v.size();
+            std::fill(e.effMult.begin(), e.effMult.begin() + n, 1.0);
+            g_host.actors->gaugeMultipliers(id, e.effMult.first(n));
+            e.effDirty = false;
+        }
+
+        void ApplyHit(RE::FormID id, Entry& e, ERF_ElementHandle elem, int delta, float atH, double nowRt) {
+            const auto i = idx(elem);
+
+            if (atH < e.blockUntilH[i] || nowRt < e.blockUntilRtS[i]) {
+                g_host.events->hit(id, elem, delta, 0, nowRt, atH);
+                return;
+            }
+            if (e.effDirty) {
+                RecomputeEffMultipliers(id, e);
+            }
+
+            const auto& T = *g_host.tuning;
+            const int before = e.v[i];
+            const float mult = g_host.actors->isPlayer(id) ? T.playerMult : T.npcMult;
+            const double scaled = std::round(static_cast<double>(delta) * mult * e.effMult[i]);
+            const int adj = (scaled <= 0.0) ? 0 : static_cast<int>(scaled);
+            const int afterI = std::clamp(before + adj, 0, 100);
+            g_host.events->hit(id, elem, delta, afterI - before, nowRt, atH);
+
+            const int sumBeforeMix = e.sumMix;
+            e.v[i] = static_cast<std::uint8_t>(afterI);
+            e.lastHitH[i] = atH;
+            e.lastEvalH[i] = atH;
+            onValChange(e, i, before, afterI);
+
+            const ERF_ElementDesc* d = ElementRegistry::get().get(elem);
+            const bool isIsolatedInMixed = d && d->noMixInMixedMode;
+
+            if (T.isSingle || isIsolatedInMixed) {
+                if (before < 100 && afterI >= 100) {
+                    TriggerReaction(id, e, elem);
+                }
+            } else {
+                if (sumBeforeMix < 100 && e.sumMix >= 100) {
+                    TriggerReaction(id, e, 0);
+                }
+            }
+            (void)MaybeTriggerPreEffectsFor(id, e, elem, static_cast<std::uint8_t>(afterI));
+        }
+    }
+
+    bool addBatch(RE::FormID id, std::span<const Hit> hits) {
+        if (hits.empty()) return false;
+
+        const float nowH = g_host.clock->nowH();
+        const double nowRt = g_host.clock->nowRt();
+
+        const auto snap = SnapshotDecay();
+        pumpDeadlines(nowRt, nowH, snap);
+
+        auto& e = acquire(id).first->second;
+        tickPresent(e, nowH, snap);
+
+        bool applied = false;
+        for (const auto& h : hits) {
+            if (h.delta <= 0) continue;
+            ApplyHit(id, e, h.elem, h.delta, std::min(h.atH, nowH), nowRt);
+            applied = true;
+        }
+        if (applied) queueDrainWake(e, id, snap);
+        return applied;
+    }
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <ankerl/unordered_dense.h>
+
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "../common/TimerWheel.h"
+#include "GaugeArena.h"
+#include "RE/Skyrim.h"
+#include "erf_element.h"
+#include "erf_preeffect.h"
+#include "erf_reaction.h"
+
+// The gauge store and its hit path: decay, deadlines, reactions, pre-effects, cooldowns and lockouts. Nothing in
+// here touches the game; ElementalGauges.cpp binds it to the calendar, the form table and SKSE's task queue, and
+// bench/ binds it to a simulated clock, so the benchmark and the replayer run the exact code the plugin runs.
+namespace Gauges {
+    inline constexpr float kGraceSec = 5.0f;
+    inline constexpr float kRealDecayPerSec = 15.0f;
+    inline constexpr bool kReserveZero = true;
+
+    struct Hit {
+        ERF_ElementHandle elem{0};
+        int delta{0};
+        float atH{0.0f};
+    };
+
+    // Real seconds since the session started, calendar hours, and the timescale that links the two.
+    class Clock {
+    public:
+        virtual ~Clock() = default;
+        virtual double nowRt() const = 0;
+        virtual float nowH() const = 0;
+        virtual float timescale() const = 0;
+    };
+
+    class Actors {
+    public:
+        virtual ~Actors() = default;
+        virtual bool isPlayer(RE::FormID id) const = 0;
+        // Dead, or no longer resolves to an actor; compaction evicts these.
+        virtual bool isGone(RE::FormID id) const = 0;
+        // out[elem] = product of the gauge multipliers of the actor's active states; out arrives filled with 1.0.
+        virtual void gaugeMultipliers(RE::FormID id, std::span<double> out) const = 0;
+    };
+
+    // Callbacks into other plugins never run inside the hit path; they are queued and the target is resolved
+    // again when they run.
+    class Tasks {
+    public:
+        virtual ~Tasks() = default;
+        virtual void reaction(RE::FormID id, ERF_ReactionCallback cb, void* user) = 0;
+        virtual void preEffect(RE::FormID id, ERF_PreEffectDesc::Callback cb, ERF_ElementHandle elem,
+                               std::uint8_t gauge, float intensity, void* user) = 0;
+    };
+
+    // What the core decided, for the HUD and the trace recorder. applied is 0 for a hit that landed on a lockout.
+    class Events {
+    public:
+        virtual ~Events() = default;
+        virtual void hit(RE::FormID, ERF_ElementHandle, int /*delta*/, int /*applied*/, double /*rt*/, float /*h*/) {}
+        virtual void reaction(RE::FormID, ERF_ReactionHandle, float /*hudSeconds*/, double /*rt*/, float /*h*/) {}
+    };
+
+    struct Tuning {
+        bool isSingle{true};
+        int maxReactionsPerTrigger{1};
+        float playerMult{1.0f};
+        float npcMult{1.0f};
+    };
+
+    struct Host {
+        Clock* clock{nullptr};
+        Actors* actors{nullptr};
+        Tasks* tasks{nullptr};
+        Events* events{nullptr};
+        const Tuning* tuning{nullptr};
+        // Runs once before the arena is sized from the registries; the plugin freezes them here.
+        void (*freeze)(){nullptr};
+    };
+
+    // Must be called before the first hit; the interfaces have to outlive the store.
+    void Bind(const Host& host);
+    const Host& host() noexcept;
+
+    struct PresentList {
+        ERF_ElementHandle* items{nullptr};
+        std::uint16_t count{0};
+
+        std::size_t size() const noexcept { return count; }
+        bool empty() const noexcept { return count == 0; }
+        ERF_ElementHandle* begin() const noexcept { return items; }
+        ERF_ElementHandle* end() const noexcept { return items + count; }
+        ERF_ElementHandle& operator[](std::size_t i) const noexcept { return items[i]; }
+        void push_back(ERF_ElementHandle h) noexcept { items[count++] = h; }
+        void pop_back() noexcept { --count; }
+        void clear() noexcept { count = 0; }
+    };
+
+    struct Entry {
+        std::uint32_t slot = Arena::kNoSlot;
+
+        std::span<std::uint8_t> v;
+        std::span<float> lastHitH;
+        std::span<float> lastEvalH;
+        std::span<float> blockUntilH;
+        std::span<double> blockUntilRtS;
+
+        std::span<double> reactCdRtS;
+        std::span<float> reactCdH;
+        std::span<std::uint8_t> inReaction;
+
+        std::span<std::uint8_t> preActive;
+        std::span<float> preIntensity;
+        std::span<double> preExpireRtS;
+        std::span<float> preExpireH;
+
+        std::span<double> effMult;
+        bool effDirty = true;
+
+        std::span<std::uint64_t> presentMask;
+        PresentList presentList;
+        int sumAll = 0;
+        int sumMix = 0;
+        std::span<std::uint16_t> posInList;
+
+        double holdUntilRtS = 0.0;
+        float holdUntilH = 0.f;
+        float drainWakeH = 0.f;
+        std::uint16_t inReactionCount = 0;
+        std::uint64_t version = 0;
+    };
+
+    using Map = ankerl::unordered_dense::map<RE::FormID, Entry>;
+
+    inline constexpr double kRtTicksPerSec = 16.0;
+    inline constexpr double kHourTicksPerHour = 3600.0;
+
+    struct Store {
+        Map map;
+        Arena arena;
+        TimerWheel<RE::FormID> rtWheel;
+        TimerWheel<RE::FormID> hourWheel;
+        std::uint64_t versionSeq = 0;
+    };
+
+    inline Store& store() noexcept {
+        static Store s;
+        if (s.map.bucket_count() == 0) s.map.reserve(512);
+        return s;
+    }
+    inline Map& state() noexcept { return store().map; }
+
+    // Versions come from one store-wide sequence, so an actor that is evicted and re-acquired never repeats one.
+    inline void touch(Entry& e) noexcept { e.version = ++store().versionSeq; }
+
+    inline std::size_t firstIndex() { return kReserveZero ? 1u : 0u; }
+    inline std::size_t idx(ERF_ElementHandle h) { return static_cast<std::size_t>(h == 0 ? 1 : h); }
+    inline std::size_t idxReact(ERF_ReactionHandle r) { return static_cast<std::size_t>(r == 0 ? 1 : r); }
+    inline std::size_t idxPre(ERF_PreEffectHandle p) { return static_cast<std::size_t>(p == 0 ? 1 : p); }
+    inline ERF_ElementHandle handleFromIndex(std::size_t i) { return static_cast<ERF_ElementHandle>(i); }
+
+    struct DecaySnapshot {
+        float ratePerHour;
+        float graceHours;
+    };
+
+    DecaySnapshot SnapshotDecay();
+
+    std::pair<Map::iterator, bool> acquire(RE::FormID id);
+    Map::iterator erase(Map::iterator it);
+    void erase(RE::FormID id);
+    void clearAll();
+
+    void onValChange(Entry& e, std::size_t i, int before, int after);
+    void tickOne(Entry& e, std::size_t i, float nowH, const DecaySnapshot& snap);
+    void tickPresent(Entry& e, float nowH, const DecaySnapshot& snap);
+    // Closed form of tickOne: the game hour at which every present element has decayed to zero, or infinity when
+    // nothing decays.
+    float drainAtH(const Entry& e, const DecaySnapshot& snap);
+
+    inline bool held(const Entry& e, double nowRt, float nowH) {
+        return e.inReactionCount > 0 || nowRt < e.holdUntilRtS || nowH < e.holdUntilH;
+    }
+    inline bool idle(const Entry& e, double nowRt, float nowH) { return e.sumAll <= 0 && !held(e, nowRt, nowH); }
+
+    void queueDrainWake(Entry& e, RE::FormID id, const DecaySnapshot& snap);
+    void scheduleLoadedHolds(Entry& e, RE::FormID id);
+    void rebuildPresence(Entry& e);
+
+    // Fires every deadline that came due since the last call. Woken actors are decayed and evicted once they
+    // hold no gauge, lock, cooldown or live pre-effect; the cost scales with expiring events, not tracked actors.
+    void pumpDeadlines(double nowRt, float nowH, const DecaySnapshot& snap);
+
+    // Closed-form decay for every entry, then eviction of idle entries and of actors that are dead or gone. Unlike
+    // the deadline wheels this touches the whole map, so it runs at save time and from the idle sweeper only.
+    std::size_t compact(double nowRt, float nowH, const DecaySnapshot& snap);
+
+    // The whole hit path for one actor: deadlines, decay, the hits in order, reactions and pre-effects. Returns
+    // false when no hit carried a positive delta.
+    bool addBatch(RE::FormID id, std::span<const Hit> hits);
+}
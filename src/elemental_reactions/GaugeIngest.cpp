@@ -0,0 +1,117 @@
+#include "GaugeIngest.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "ElementalGauges.h"
+#include "SKSE/SKSE.h"
+
+namespace {
+    struct Record {
+        RE::FormID id;
+        ERF_ElementHandle elem;
+        std::int32_t delta;
+        float atH;
+    };
+
+    constexpr std::uint32_t kRingCap = 1024;
+    constexpr std::size_t kMaxRings = 64;
+
+    // Single producer (the owning thread), single consumer (the task that drains).
+    struct Ring {
+        alignas(64) std::atomic<std::uint32_t> head{0};
+        alignas(64) std::atomic<std::uint32_t> tail{0};
+        alignas(64) std::array<Record, kRingCap> buf{};
+
+        bool push(const Record& r) noexcept {
+            const auto h = head.load(std::memory_order_relaxed);
+            if (h - tail.load(std::memory_order_acquire) >= kRingCap) return false;
+            buf[h & (kRingCap - 1)] = r;
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        void popAll(std::vector<Record>& out) {
+            const auto t = tail.load(std::memory_order_relaxed);
+            const auto h = head.load(std::memory_order_acquire);
+            for (auto i = t; i != h; ++i) out.push_back(buf[i & (kRingCap - 1)]);
+            tail.store(h, std::memory_order_release);
+        }
+    };
+
+    std::array<std::atomic<Ring*>, kMaxRings> g_rings{};
+    std::atomic<std::size_t> g_ringCount{0};
+
+    std::mutex g_overflowLock;
+    std::vector<Record> g_overflow;
+
+    std::atomic_bool g_drainQueued{false};
+
+    // Game threads live for the whole session, so rings are never handed back.
+    Ring* LocalRing() {
+        thread_local Ring* ring = []() -> Ring* {
+            const auto slot = g_ringCount.fetch_add(1, std::memory_order_acq_rel);
+            if (slot >= kMaxRings) return nullptr;
+            auto* r = new Ring{};
+            g_rings[slot].store(r, std::memory_order_release);
+            return r;
+        }();
+        return ring;
+    }
+}
+
+void GaugeIngest::Push(RE::Actor* a, ERF_ElementHandle elem, int delta) {
+    if (!a || delta <= 0) return;
+
+    auto* tasks = SKSE::GetTaskInterface();
+    if (!tasks) {
+        ElementalGauges::Add(a, elem, delta);
+        return;
+    }
+
+    const Record r{a->GetFormID(), elem, delta, ElementalGaugesDecay::NowHours()};
+    if (auto* ring = LocalRing(); !ring || !ring->push(r)) {
+        std::scoped_lock lk(g_overflowLock);
+        g_overflow.push_back(r);
+    }
+
+    if (!g_drainQueued.exchange(true, std::memory_order_acq_rel)) {
+        tasks->AddTask([]() { Drain(); });
+    }
+}
+
+void GaugeIngest::Drain() {
+    g_drainQueued.exchange(false, std::memory_order_acq_rel);
+
+    static std::vector<Record> batch;
+    static std::vector<ElementalGauges::Hit> hits;
+    batch.clear();
+
+    const auto n = std::min(g_ringCount.load(std::memory_order_acquire), kMaxRings);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (auto* ring = g_rings[i].load(std::memory_order_acquire)) ring->popAll(batch);
+    }
+    {
+        std::scoped_lock lk(g_overflowLock);
+        batch.insert(batch.end(), g_overflow.begin(), g_overflow.end());
+        g_overflow.clear();
+    }
+    if (batch.empty()) return;
+
+    std::ranges::stable_sort(batch, {}, &Record::id);
+
+    for (std::size_t i = 0; i < batch.size();) {
+        const auto id = batch[i].id;
+        hits.clear();
+        for (; i < batch.size() && batch[i].id == id; ++i) {
+            hits.push_back(ElementalGauges::Hit{batch[i].elem, batch[i].delta, batch[i].atH});
+        }
+        if (auto* a = RE::TESForm::LookupByID<RE::Actor>(id)) {
+            ElementalGauges::AddBatch(a, hits);
+        }
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "RE/Skyrim.h"
+#include "erf_element.h"
+
+namespace GaugeIngest {
+    void Push(RE::Actor* a, ERF_ElementHandle elem, int delta);
+    void Drain();
+}
@@ -0,0 +1,223 @@
+#include "GaugeTrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "../Config.h"
+#include "ElementalGauges.h"
+#include "ElementalStates.h"
+#include "SKSE/SKSE.h"
+
+namespace {
+    using GaugeTrace::Record;
+
+    constexpr std::uint64_t kCap = std::uint64_t{1} << 16;
+    constexpr auto kFlushEvery = std::chrono::milliseconds(250);
+
+    // Bounded MPSC queue: producers claim a cell with a CAS on head, the flusher is the only consumer.
+    struct Queue {
+        struct Cell {
+            std::atomic<std::uint64_t> seq{0};
+            Record rec{};
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        alignas(64) std::atomic<std::uint64_t> head{0};
+        alignas(64) std::uint64_t tail{0};
+
+        void init() {
+            if (!cells) cells = std::make_unique<Cell[]>(kCap);
+            for (std::uint64_t i = 0; i < kCap; ++i) cells[i].seq.store(i, std::memory_order_relaxed);
+            head.store(0, std::memory_order_relaxed);
+            tail = 0;
+        }
+
+        bool push(const Record& r) noexcept {
+            auto pos = head.load(std::memory_order_relaxed);
+            for (;;) {
+                auto& c = cells[pos & (kCap - 1)];
+                const auto seq = c.seq.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::int64_t>(seq - pos);
+                if (diff == 0) {
+                    if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        c.rec = r;
+                        c.seq.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void popAll(std::vector<Record>& out) {
+            for (;;) {
+                auto& c = cells[tail & (kCap - 1)];
+                if (c.seq.load(std::memory_order_acquire) != tail + 1) break;
+                out.push_back(c.rec);
+                c.seq.store(tail + kCap, std::memory_order_release);
+                ++tail;
+            }
+        }
+    };
+
+    Queue g_queue;
+    std::atomic<std::uint64_t> g_dropped{0};
+
+    std::mutex g_lifeLock;
+    std::condition_variable_any g_cv;
+    // A jthread so a trace still running at exit is stopped and joined instead of terminating the process.
+    std::jthread g_flusher;
+
+    void Emit(const Record& r) {
+        if (!g_queue.push(r)) g_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void FillStates(Record& r, RE::Actor* a) {
+        constexpr std::size_t kBits = sizeof(Record::states) * 8;
+        for (auto sh : ElementalStates::GetActive(a)) {
+            if (sh >= 1 && sh <= kBits) r.states[(sh - 1) >> 6] |= std::uint64_t{1} << ((sh - 1) & 63);
+        }
+    }
+
+    template <class T>
+    void Put(std::ofstream& out, const T& v) {
+        out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    void WriteContent(std::ofstream& out) {
+        const auto& ER = ElementRegistry::get();
+        const auto& RR = ReactionRegistry::get();
+
+        GaugeTrace::FileHeader h{};
+        h.recordSize = sizeof(Record);
+        h.numElements = static_cast<std::uint16_t>(ER.size());
+        h.numReactions = static_cast<std::uint16_t>(RR.size());
+        h.timescale = ElementalGaugesDecay::Timescale();
+        h.maxReactionsPerTrigger = static_cast<std::uint16_t>(
+            std::clamp(ERF::GetConfig().maxReactionsPerTrigger.load(std::memory_order_relaxed), 1, 0xFFFF));
+        h.isSingle = ERF::GetConfig().isSingle.load(std::memory_order_relaxed) ? 1 : 0;
+        Put(out, h);
+
+        for (ERF_ElementHandle e = 1; e <= h.numElements; ++e) {
+            const auto* d = ER.get(e);
+            Put(out, static_cast<std::uint8_t>(d && d->noMixInMixedMode ? 1 : 0));
+        }
+
+        for (ERF_ReactionHandle r = 1; r <= h.numReactions; ++r) {
+            const auto* d = RR.get(r);
+            GaugeTrace::ReactionRow row{};
+            if (d) {
+                row.minPctEach = d->minPctEach;
+                row.minSumSelected = d->minSumSelected;
+                row.cooldownSeconds = d->cooldownSeconds;
+                row.elementLockoutSeconds = d->elementLockoutSeconds;
+                row.elementCount = static_cast<std::uint16_t>(d->elements.size());
+                row.ordered = d->ordered ? 1 : 0;
+            }
+            Put(out, row);
+            if (d) {
+                for (auto eh : d->elements) Put(out, static_cast<std::uint16_t>(eh));
+            }
+        }
+    }
+
+    void FlushLoop(std::stop_token st, std::ofstream out) {
+        std::vector<Record> batch;
+        batch.reserve(4096);
+
+        for (;;) {
+            bool stopping = false;
+            {
+                std::unique_lock lk(g_lifeLock);
+                g_cv.wait_for(lk, st, kFlushEvery, [] { return !GaugeTrace::Recording(); });
+                stopping = st.stop_requested() || !GaugeTrace::Recording();
+            }
+
+            batch.clear();
+            g_queue.popAll(batch);
+            if (!batch.empty()) {
+                out.write(reinterpret_cast<const char*>(batch.data()),
+                          static_cast<std::streamsize>(batch.size() * sizeof(Record)));
+                out.flush();
+            }
+            if (stopping) break;
+        }
+
+        if (const auto dropped = g_dropped.exchange(0); dropped > 0) {
+            spdlog::warn("[ERF] gauge trace dropped {} records (queue full).", dropped);
+        }
+    }
+}
+
+void GaugeTrace::Start() {
+    std::scoped_lock lk(g_lifeLock);
+    if (Recording() || g_flusher.joinable()) return;
+
+    auto dir = SKSE::log::log_directory();
+    if (!dir) return;
+    const auto path = *dir / "ERF" / "ERFGauges.trace";
+
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        spdlog::warn("[ERF] could not open gauge trace at {}", path.string());
+        return;
+    }
+    WriteContent(out);
+
+    g_queue.init();
+    g_dropped.store(0, std::memory_order_relaxed);
+    g_recording.store(true, std::memory_order_release);
+    g_flusher = std::jthread(FlushLoop, std::move(out));
+    spdlog::info("[ERF] recording gauge trace to {}", path.string());
+}
+
+void GaugeTrace::Stop() {
+    {
+        std::scoped_lock lk(g_lifeLock);
+        if (!g_recording.exchange(false)) return;
+    }
+    g_cv.notify_all();
+    if (g_flusher.joinable()) g_flusher.join();
+}
+
+void GaugeTrace::Hit(RE::Actor* a, ERF_ElementHandle elem, int delta, int applied, double rtS, float hours) {
+    if (!a || !Recording()) return;
+
+    Record r{};
+    r.rtS = rtS;
+    r.hours = hours;
+    r.actor = a->GetFormID();
+    FillStates(r, a);
+    r.elem = elem;
+    r.delta = static_cast<std::int16_t>(std::clamp(delta, -32768, 32767));
+    r.applied = static_cast<std::uint8_t>(std::clamp(applied, 0, 255));
+    r.kind = RecordKind::kHit;
+    Emit(r);
+}
+
+void GaugeTrace::Reaction(RE::Actor* a, ERF_ReactionHandle rh, double rtS, float hours) {
+    if (!a || !Recording()) return;
+
+    Record r{};
+    r.rtS = rtS;
+    r.hours = hours;
+    r.actor = a->GetFormID();
+    FillStates(r, a);
+    r.reaction = rh;
+    r.kind = RecordKind::kReaction;
+    Emit(r);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <atomic>
+
+#include "GaugeTraceFormat.h"
+#include "RE/Skyrim.h"
+#include "erf_element.h"
+#include "erf_reaction.h"
+
+// Opt-in hit/reaction recorder ([Debug] TraceGauges in the INI). Replay with bench/erf_replay.
+namespace GaugeTrace {
+    inline std::atomic_bool g_recording{false};
+    inline bool Recording() noexcept { return g_recording.load(std::memory_order_relaxed); }
+
+    void Start();
+    void Stop();
+    void Hit(RE::Actor* a, ERF_ElementHandle elem, int delta, int applied, double rtS, float hours);
+    void Reaction(RE::Actor* a, ERF_ReactionHandle rh, double rtS, float hours);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout shared by the in-game recorder and the headless replayer (bench/erf_replay).
+// File = header, element table, reaction table, then records until EOF.
+namespace GaugeTrace {
+    inline constexpr std::uint32_t kMagic = 0x54465245u;  // "ERFT"
+    inline constexpr std::uint32_t kVersion = 2;
+
+    enum class RecordKind : std::uint8_t { kHit = 1, kReaction = 2 };
+
+    struct FileHeader {
+        std::uint32_t magic{kMagic};
+        std::uint32_t version{kVersion};
+        std::uint32_t recordSize{0};
+        std::uint16_t numElements{0};
+        std::uint16_t numReactions{0};
+        // Settings the gauges ran with when recording started; replay reuses them.
+        float timescale{20.0f};
+        std::uint16_t maxReactionsPerTrigger{1};
+        std::uint8_t isSingle{0};
+        std::uint8_t pad{0};
+    };
+    static_assert(sizeof(FileHeader) == 24);
+
+    // Followed by numElements of: std::uint8_t noMixInMixedMode.
+    // Then numReactions of: ReactionRow, then elementCount x std::uint16_t element handles.
+    struct ReactionRow {
+        float minPctEach{0.f};
+        float minSumSelected{0.f};
+        float cooldownSeconds{0.f};
+        float elementLockoutSeconds{0.f};
+        std::uint16_t elementCount{0};
+        std::uint8_t ordered{0};
+        std::uint8_t pad{0};
+    };
+    static_assert(sizeof(ReactionRow) == 20);
+
+    // kHit: delta is what the caller asked for, applied is what reached the gauge after multipliers (0 when locked).
+    // kReaction: reaction is the handle that fired; elem/delta/applied are 0.
+    // states: bit (h - 1) set for each active state handle h, covering all 256 handles.
+    struct Record {
+        double rtS{0.0};
+        float hours{0.f};
+        std::uint32_t actor{0};
+        std::uint64_t states[4]{};
+        std::uint16_t elem{0};
+        std::uint16_t reaction{0};
+        std::int16_t delta{0};
+        std::uint8_t applied{0};
+        RecordKind kind{RecordKind::kHit};
+    };
+    static_assert(sizeof(Record) == 56);
+}
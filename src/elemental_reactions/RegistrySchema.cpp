@@ -0,0 +1,145 @@
+#include "RegistrySchema.h"
+
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+#include "../common/Helpers.h"
+#include "../common/PluginSerialization.h"
+#include "erf_element.h"
+#include "erf_preeffect.h"
+#include "erf_reaction.h"
+#include "erf_state.h"
+
+namespace {
+    inline constexpr std::uint32_t kRecordID = FOURCC('E', 'R', 'F', 'S');
+    inline constexpr std::uint32_t kVersion = 1;
+
+    RegistrySchema::Remap g_remap;
+
+    std::uint64_t NameHash(std::string_view s) {
+        std::uint64_t h = 1469598103934665603ull;
+        for (unsigned char c : s) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    template <class Registry>
+    void HashNames(const Registry& R, std::vector<std::uint64_t>& out) {
+        out.assign(R.size() + 1, 0);
+        for (std::size_t h = 1; h < out.size(); ++h) {
+            if (const auto* d = R.get(static_cast<std::uint16_t>(h))) out[h] = NameHash(d->name);
+        }
+    }
+
+    // Index = handle; slot 0 is unused.
+    std::array<std::vector<std::uint64_t>, RegistrySchema::kKinds> CurrentSchema() {
+        std::array<std::vector<std::uint64_t>, RegistrySchema::kKinds> s;
+        HashNames(ElementRegistry::get(), s[0]);
+        HashNames(ReactionRegistry::get(), s[1]);
+        HashNames(PreEffectRegistry::get(), s[2]);
+        HashNames(StateRegistry::get(), s[3]);
+        return s;
+    }
+
+    // Record: u32 kinds, then per kind a u32 count and count name hashes for handles 1..count.
+    bool Save(SKSE::SerializationInterface* ser, bool dryRun) {
+        const auto schema = CurrentSchema();
+        if (dryRun) {
+            for (const auto& v : schema) {
+                if (v.size() > 1) return true;
+            }
+            return false;
+        }
+
+        std::vector<std::uint8_t> buf;
+        const auto put = [&buf]<class T>(const T& v) {
+            const auto* p = reinterpret_cast<const std::uint8_t*>(&v);
+            buf.insert(buf.end(), p, p + sizeof(T));
+        };
+        put(static_cast<std::uint32_t>(schema.size()));
+        for (const auto& v : schema) {
+            put(static_cast<std::uint32_t>(v.size() - 1));
+            for (std::size_t h = 1; h < v.size(); ++h) put(v[h]);
+        }
+        return ser->WriteRecordData(buf.data(), static_cast<std::uint32_t>(buf.size()));
+    }
+
+    void BuildRemap(const std::array<std::vector<std::uint64_t>, RegistrySchema::kKinds>& saved) {
+        const auto current = CurrentSchema();
+        auto& R = g_remap;
+        R = {};
+
+        bool identity = true;
+        for (std::size_t k = 0; k < RegistrySchema::kKinds; ++k) {
+            const auto& from = saved[k];
+            const auto& to = current[k];
+
+            // Names are few; one index per kind keeps the build linear instead of per-actor lookups on load.
+            std::unordered_map<std::uint64_t, std::uint16_t> byHash;
+            byHash.reserve(to.size());
+            for (std::size_t h = to.size(); h-- > 1;) byHash[to[h]] = static_cast<std::uint16_t>(h);
+
+            auto& o2n = R.oldToNew[k];
+            auto& n2o = R.newToOld[k];
+            o2n.assign(from.size(), 0);
+            n2o.assign(to.size(), 0);
+            for (std::size_t h = 1; h < from.size(); ++h) {
+                const auto it = byHash.find(from[h]);
+                if (it == byHash.end()) continue;
+                o2n[h] = it->second;
+                if (n2o[it->second] == 0) n2o[it->second] = static_cast<std::uint32_t>(h);
+            }
+            // Handles appended since the save still leave the saved ones in place.
+            if (from.size() > to.size()) identity = false;
+            for (std::size_t h = 1; identity && h < from.size(); ++h) identity = o2n[h] == h;
+        }
+        R.identity = identity;
+
+        if (!identity) {
+            spdlog::info("[ERF] registry layout changed since this save; gauge and state handles were remapped.");
+        }
+    }
+
+    bool Load(SKSE::SerializationInterface* ser, std::uint32_t version, std::uint32_t length) {
+        g_remap = {};
+        if (version != kVersion) return false;
+
+        std::vector<std::uint8_t> buf(length);
+        if (length != 0 && ser->ReadRecordData(buf.data(), length) != length) return false;
+
+        const std::uint8_t* p = buf.data();
+        const std::uint8_t* end = p + buf.size();
+        const auto take = [&]<class T>(T& v) {
+            if (static_cast<std::size_t>(end - p) < sizeof(T)) return false;
+            std::memcpy(&v, p, sizeof(T));
+            p += sizeof(T);
+            return true;
+        };
+
+        std::uint32_t kinds{};
+        if (!take(kinds)) return false;
+
+        std::array<std::vector<std::uint64_t>, RegistrySchema::kKinds> saved;
+        for (std::uint32_t k = 0; k < kinds; ++k) {
+            std::uint32_t n{};
+            if (!take(n)) return false;
+            std::vector<std::uint64_t> hashes(std::size_t{n} + 1, 0);
+            for (std::uint32_t h = 1; h <= n; ++h) {
+                if (!take(hashes[h])) return false;
+            }
+            if (k < RegistrySchema::kKinds) saved[k] = std::move(hashes);
+        }
+
+        BuildRemap(saved);
+        return true;
+    }
+
+    void Revert() { g_remap = {}; }
+}
+
+const RegistrySchema::Remap& RegistrySchema::Active() noexcept { return g_remap; }
+
+void RegistrySchema::RegisterStore() { Ser::Register({kRecordID, kVersion, &Save, &Load, &Revert}); }
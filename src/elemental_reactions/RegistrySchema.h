@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace RegistrySchema {
+    enum class Kind : std::uint8_t { kElement, kReaction, kPreEffect, kState };
+    inline constexpr std::size_t kKinds = 4;
+
+    // Translates handles saved under another registration order into the current registries. Built once when the
+    // schema record is loaded; identity when the save carried none or nothing moved. Handle 0 means "no longer
+    // registered", and index 0 of every stored array is the unused reserved slot, so gathers through it read a
+    // default value.
+    struct Remap {
+        bool identity = true;
+        std::array<std::vector<std::uint16_t>, kKinds> oldToNew;
+        std::array<std::vector<std::uint32_t>, kKinds> newToOld;
+
+        std::size_t toNew(Kind k, std::size_t oldH) const noexcept {
+            if (identity) return oldH;
+            const auto& m = oldToNew[static_cast<std::size_t>(k)];
+            return oldH < m.size() ? m[oldH] : 0;
+        }
+
+        // dst[new] = src[old] for every current handle; one branch-free pass the compiler can vectorize.
+        template <class T>
+        void gather(Kind k, std::span<T> dst, std::span<const T> src) const {
+            if (identity || src.empty()) {
+                const std::size_t n = dst.size() < src.size() ? dst.size() : src.size();
+                for (std::size_t i = 0; i < n; ++i) dst[i] = src[i];
+                return;
+            }
+            const auto& m = newToOld[static_cast<std::size_t>(k)];
+            const std::size_t n = dst.size() < m.size() ? dst.size() : m.size();
+            const std::uint32_t last = static_cast<std::uint32_t>(src.size() - 1);
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::uint32_t j = m[i];
+                dst[i] = src[j <= last ? j : 0];
+            }
+        }
+    };
+
+    // The remap for the save being loaded; reset on revert.
+    const Remap& Active() noexcept;
+
+    // Registers the schema co-save record. Must run before the stores whose handles it describes, so the record is
+    // written, and therefore read back, ahead of theirs.
+    void RegisterStore();
+}
@@ -26,10 +26,8 @@ void ElementRegistry::freeze() {
     _nameIndex.reserve(_elems.size());
     _kwIndex.reserve(_elems.size());
 
-    const std::size_t cap = StateRegistry::get().size() + 1;
     for (ERF_ElementHandle h = 1; h <= static_cast<ERF_ElementHandle>(size()); ++h) {
         auto& d = _elems[static_cast<std::size_t>(h)];
-        if (d.stateMultDense.size() < cap) d.stateMultDense.resize(cap, 1.0);
         if (!d.name.empty()) _nameIndex.try_emplace(std::string_view{d.name}, h);
         if (d.keyword) _kwIndex.try_emplace(d.keyword->GetFormID(), h);
     }
@@ -15,19 +15,7 @@ struct ERF_ElementDesc {
     std::string name;
     std::uint32_t colorRGB;
     RE::BGSKeyword* keyword;
-    std::vector<double> stateMultDense;
     bool noMixInMixedMode{false};
-    void setMultiplierForState(ERF_StateHandle sh, double mult) {
-        if (sh == 0) return;
-        const std::size_t need = static_cast<std::size_t>(sh) + 1;
-        if (stateMultDense.size() < need) stateMultDense.resize(need, 1.0);
-        stateMultDense[sh] = mult;
-    }
-    double getMultiplierForState(ERF_StateHandle sh, double fallback = 1.0) const {
-        if (sh == 0) return fallback;
-        const std::size_t i = static_cast<std::size_t>(sh);
-        return (i < stateMultDense.size()) ? stateMultDense[i] : fallback;
-    }
 };
 
 class ElementRegistry {
@@ -1,10 +1,47 @@
 #include "erf_reaction.h"
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <numeric>
+#include <utility>
+
+// The requirement lanes need AVX2 gathers. The plugin is built for baseline x64, so only the lane evaluator is
+// compiled for AVX2 and it is picked at startup from CPUID; without AVX2 every pick takes the per-candidate walk.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #include <immintrin.h>
+    #define ERF_REACT_AVX2 1
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define ERF_TARGET_AVX2
+    #else
+        #define ERF_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
 
 namespace {
+    bool CpuHasAvx2() noexcept {
+#if !defined(ERF_REACT_AVX2)
+        return false;
+#elif defined(_MSC_VER) && !defined(__clang__)
+        int r[4]{};
+        __cpuid(r, 0);
+        if (r[0] < 7) return false;
+        __cpuid(r, 1);
+        constexpr int kOsXsave = 1 << 27;
+        constexpr int kAvx = 1 << 28;
+        if ((r[2] & (kOsXsave | kAvx)) != (kOsXsave | kAvx)) return false;
+        // The OS must also save the YMM registers on a context switch.
+        if ((_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(r, 7, 0);
+        return (r[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
     int valueForHandle(std::span<const std::uint8_t> totals, ERF_ElementHandle h) {
         if (h == 0) return 0;
         const auto idx = static_cast<std::size_t>(h);
@@ -12,10 +49,6 @@ namespace {
     }
     constexpr float EPS = 1e-6f;
 
-    bool isReactionUsed(const std::vector<bool>* used, ERF_ReactionHandle h) {
-        return used && h < used->size() && (*used)[h];
-    }
-
     bool isBetterCandidate(ERF_ReactionHandle h, float fracSel, std::size_t k, ERF_ReactionHandle bestH,
                            float bestScore, std::size_t bestK) {
         if (fracSel > bestScore) {
@@ -36,8 +69,121 @@ namespace {
 
         return h < bestH;
     }
+
+    // Present element values widened to 32 bits and indexed by handle, for the requirement-lane gathers. Only the
+    // present slots are written and they are cleared again on scope exit, so every other slot, slot 0 included,
+    // reads 0 without touching the whole buffer per call.
+    class PresentValues {
+    public:
+        PresentValues(std::size_t slots, std::span<const std::uint8_t> totals,
+                      std::span<const ERF_ElementHandle> present)
+            : _present(present), _slots(slots) {
+            auto& v = buffer();
+            if (v.size() < slots) v.resize(slots, 0);
+            _data = v.data();
+            for (auto h : present) {
+                if (h != 0 && h < slots) _data[h] = valueForHandle(totals, h);
+            }
+        }
+        ~PresentValues() {
+            for (auto h : _present) {
+                if (h < _slots) _data[h] = 0;
+            }
+        }
+        PresentValues(const PresentValues&) = delete;
+        PresentValues& operator=(const PresentValues&) = delete;
+
+        const std::int32_t* data() const { return _data; }
+
+    private:
+        static std::vector<std::int32_t>& buffer() {
+            thread_local std::vector<std::int32_t> v;
+            return v;
+        }
+
+        std::span<const ERF_ElementHandle> _present;
+        std::size_t _slots;
+        std::int32_t* _data = nullptr;
+    };
 }
 
+bool ReactionRegistry::_batchEval = CpuHasAvx2();
+
+void ReactionRegistry::setBatchEval(bool on) noexcept { _batchEval = on && CpuHasAvx2(); }
+
+// The best reactions seen by one walk, bounded to the requested count. A full-score candidate (the whole gauge in its
+// elements) settles a slot outright in walk order, which is where a single pick stops walking; the remaining slots
+// hold the best partial scores by the usual score, size, handle order. Kept as a heap with the weakest entry on top,
+// in inline storage for the usual handful of picks.
+class ReactionRegistry::PickSet {
+public:
+    struct Pick {
+        ERF_ReactionHandle h{0};
+        std::uint8_t k{0};
+        bool full{false};
+        float score{0.0f};
+        std::uint32_t seq{0};
+    };
+
+    explicit PickSet(std::size_t cap) : _cap(std::max<std::size_t>(cap, 1)) {
+        if (_cap > kInline) _spill.resize(_cap);
+    }
+
+    // Returns true when nothing later in the walk can change the result.
+    bool offer(ERF_ReactionHandle h, float score, std::size_t k) {
+        Pick p{h, static_cast<std::uint8_t>(k), score >= 1.0f - EPS, score, _seq++};
+        auto* heap = data();
+        if (_n < _cap) {
+            heap[_n++] = p;
+            std::push_heap(heap, heap + _n, better);
+        } else if (_cap == 1) {
+            if (replacesSingle(p, heap[0])) heap[0] = p;
+        } else if (better(p, heap[0])) {
+            std::pop_heap(heap, heap + _n, better);
+            heap[_n - 1] = p;
+            std::push_heap(heap, heap + _n, better);
+        }
+        if (p.full) ++_full;
+        return _full >= _cap;
+    }
+
+    // Best first.
+    std::span<const Pick> sorted() {
+        auto* heap = data();
+        std::sort_heap(heap, heap + _n, better);
+        return {heap, _n};
+    }
+
+private:
+    static constexpr std::size_t kInline = 8;
+
+    // Heap order: must stay a strict weak ordering, so scores compare exactly and seq breaks the last ties.
+    static bool better(const Pick& a, const Pick& b) {
+        if (a.full != b.full) return a.full;
+        if (a.full) return a.seq < b.seq;
+        if (a.score != b.score) return a.score > b.score;
+        if (a.k != b.k) return a.k > b.k;
+        if (a.h != b.h) return a.h < b.h;
+        return a.seq < b.seq;
+    }
+
+    // A single pick never sorts, so it keeps the near-tie rule of the plain search.
+    static bool replacesSingle(const Pick& a, const Pick& b) {
+        if (a.full != b.full) return a.full;
+        if (a.full) return false;
+        return isBetterCandidate(a.h, a.score, a.k, b.h, b.score, b.k);
+    }
+
+    Pick* data() { return _cap > kInline ? _spill.data() : _inline.data(); }
+
+    std::array<Pick, kInline> _inline{};
+    std::vector<Pick> _spill;
+    std::size_t _cap;
+    std::size_t _n = 0;
+    std::size_t _full = 0;
+    std::uint32_t _seq = 0;
+};
+
 ReactionRegistry& ReactionRegistry::get() {
     static ReactionRegistry R;
     if (R._reactions.empty()) R._reactions.resize(1);
@@ -81,12 +227,12 @@ const ERF_ReactionDesc* ReactionRegistry::get(ERF_ReactionHandle h) const {
 
 std::size_t ReactionRegistry::size() const noexcept { return (!_reactions.empty()) ? (_reactions.size() - 1) : 0; }
 
-ReactionRegistry::Mask ReactionRegistry::makeMask_(const std::vector<ERF_ElementHandle>& elems) {
-    Mask m = 0;
+template <std::size_t Words>
+ElementMask<Words> ReactionRegistry::makeMask_(std::span<const ERF_ElementHandle> elems) {
+    ElementMask<Words> m{};
     for (auto h : elems) {
         if (h == 0) continue;
-        const auto bit = static_cast<unsigned>(h - 1);
-        if (bit < 64) m |= (Mask(1) << bit);
+        m.set(static_cast<std::size_t>(h - 1));
     }
     return m;
 }
@@ -95,8 +241,6 @@ void ReactionRegistry::buildIndex_() const {
     if (_indexed) return;
 
     const auto N = _reactions.size();
-    _maskByH.clear();
-    _maskByH.resize(N, 0);
     _kByH.clear();
     _kByH.resize(N, 0);
     _minTotalByH.clear();
@@ -106,28 +250,137 @@ void ReactionRegistry::buildIndex_() const {
     _minSumSelByH.clear();
     _minSumSelByH.resize(N, 0.0f);
 
-    _byMask.clear();
-    _byMask.reserve(N * 2);
-
+    std::size_t maxElem = ElementRegistry::get().size();
     for (ERF_ReactionHandle h = 1; h < N; ++h) {
         const auto& r = _reactions[h];
-        const auto m = makeMask_(r.elements);
-        const auto k = static_cast<std::uint8_t>(r.elements.size());
-
-        _maskByH[h] = m;
-        _kByH[h] = k;
+        _kByH[h] = static_cast<std::uint8_t>(r.elements.size());
         _minPctEachByH[h] = r.minPctEach;
         _minSumSelByH[h] = r.minSumSelected;
 
-        auto [__itB, __insertedB] = _byMask.try_emplace(m);
-        auto& bucket = __itB->second;
-        if (bucket.empty()) bucket.reserve(4);
-        bucket.push_back(h);
+        for (auto eh : r.elements) maxElem = std::max<std::size_t>(maxElem, eh);
+    }
+
+    buildRequirementLanes_(maxElem);
+
+    if (maxElem > ElementMask<kMaxMaskWords>::kBits) {
+        spdlog::warn("[ERF] {} elements registered; reactions only see the first {}.", maxElem,
+                     ElementMask<kMaxMaskWords>::kBits);
+    }
+
+    switch (MaskWordsFor(maxElem)) {
+        case 1:
+            buildDecisionTable_(_index.emplace<Index<1>>());
+            break;
+        case 2:
+            buildDecisionTable_(_index.emplace<Index<2>>());
+            break;
+        case 4:
+            buildDecisionTable_(_index.emplace<Index<4>>());
+            break;
+        default:
+            buildDecisionTable_(_index.emplace<Index<kMaxMaskWords>>());
+            break;
     }
 
     _indexed = true;
 }
 
+template <std::size_t Words>
+void ERF_ReactionIndex<Words>::build(std::span<const Mask> masks) {
+    const auto N = masks.size();
+    maskByH.assign(masks.begin(), masks.end());
+    if (N > 0) maskByH[0] = Mask{};
+
+    std::vector<ERF_ReactionHandle> order;
+    order.reserve(N);
+
+    Mask used{};
+    for (ERF_ReactionHandle h = 1; h < N; ++h) {
+        const auto& m = maskByH[h];
+        if (!m.any()) continue;
+
+        order.push_back(h);
+        for (std::size_t w = 0; w < Words; ++w) used.w[w] |= m.w[w];
+    }
+
+    // Same priority the subset walk used: larger masks first, then lower handles.
+    std::ranges::stable_sort(order, [&](ERF_ReactionHandle a, ERF_ReactionHandle b) { return maskByH[a] > maskByH[b]; });
+
+    highStart.assign(Mask::kBits + 1, 0);
+    for (auto h : order) ++highStart[static_cast<std::size_t>(maskByH[h].highBit()) + 1];
+    for (std::size_t b = 1; b < highStart.size(); ++b) highStart[b] += highStart[b - 1];
+
+    byHighBit.assign(order.size(), 0);
+    byHighBitMask.assign(order.size(), Mask{});
+    auto fill = highStart;
+    for (auto h : order) {
+        const auto at = fill[static_cast<std::size_t>(maskByH[h].highBit())]++;
+        byHighBit[at] = h;
+        byHighBitMask[at] = maskByH[h];
+    }
+
+    denseBits = 0;
+    denseStart.clear();
+    dense.clear();
+
+    const auto bits = static_cast<unsigned>(used.highBit() + 1);
+    if (bits == 0 || bits > kDenseMaxBits) return;
+
+    const std::size_t count = std::size_t{1} << bits;
+    std::size_t total = 0;
+    for (auto h : order) total += count >> maskByH[h].popcount();
+    if (total > kDenseMaxEntries) return;
+
+    denseStart.reserve(count + 1);
+    dense.reserve(total);
+    for (std::uint64_t pm = 0; pm < count; ++pm) {
+        denseStart.push_back(static_cast<std::uint32_t>(dense.size()));
+        for (auto h : order) {
+            if ((maskByH[h].w[0] & ~pm) == 0) dense.push_back(h);
+        }
+    }
+    denseStart.push_back(static_cast<std::uint32_t>(dense.size()));
+    denseBits = bits;
+}
+
+template struct ERF_ReactionIndex<1>;
+template struct ERF_ReactionIndex<2>;
+template struct ERF_ReactionIndex<4>;
+template struct ERF_ReactionIndex<kMaxMaskWords>;
+
+template <std::size_t Words>
+void ReactionRegistry::buildDecisionTable_(Index<Words>& ix) const {
+    std::vector<ElementMask<Words>> masks(_reactions.size());
+    for (std::size_t h = 1; h < masks.size(); ++h) masks[h] = makeMask_<Words>(_reactions[h].elements);
+    ix.build(masks);
+}
+
+void ReactionRegistry::buildRequirementLanes_(std::size_t maxElem) const {
+    const auto N = _reactions.size();
+    auto& R = _req;
+    R.stride = N;
+    R.valueSlots = maxElem + 1;
+    R.elem.assign(kReqLanes * N, 0);
+    R.minPct.assign(kReqLanes * N, -1.0f);
+    R.minSum.assign(N, -1.0f);
+    R.ordered.assign(N, 0);
+    R.wide.assign(N, 0);
+
+    for (std::size_t h = 1; h < N; ++h) {
+        const auto& r = _reactions[h];
+        if (r.elements.size() > kReqLanes) {
+            R.wide[h] = 1;
+            continue;
+        }
+        for (std::size_t j = 0; j < r.elements.size(); ++j) {
+            R.elem[j * N + h] = r.elements[j];
+            if (r.minPctEach > 0.0f) R.minPct[j * N + h] = r.minPctEach;
+        }
+        if (r.minSumSelected > 0.0f) R.minSum[h] = r.minSumSelected;
+        if (r.ordered) R.ordered[h] = -1;
+    }
+}
+
 void ReactionRegistry::freeze() { buildIndex_(); }  // NOSONAR - freeze() intentionally mutates the registry state
 
 bool ReactionRegistry::checkEachElementPct(ERF_ReactionHandle h, const ERF_ReactionDesc& r,
@@ -166,81 +419,148 @@ bool ReactionRegistry::checkMinSumSel(ERF_ReactionHandle h, int sumSel, float in
     return true;
 }
 
-void ReactionRegistry::evalBucketForPickBest(Mask m, std::span<const std::uint8_t> totals, float invSumAll,
-                                             const std::vector<bool>* used, ERF_ReactionHandle& bestH, float& bestScore,
-                                             std::size_t& bestK) const {
-    auto itB = _byMask.find(m);
-    if (itB == _byMask.end()) {
-        return;
+bool ReactionRegistry::evalCandidate(ERF_ReactionHandle h, std::span<const std::uint8_t> totals, float invSumAll,
+                                     PickSet& picks) const {
+    const auto& r = _reactions[h];
+
+    int sumSel = 0;
+    if (!checkEachElementPct(h, r, totals, invSumAll, sumSel)) {
+        return false;
     }
 
-    const auto& bucket = itB->second;
-    for (ERF_ReactionHandle h : bucket) {
-        if (isReactionUsed(used, h)) {
-            continue;
-        }
+    float fracSel = 0.0f;
+    if (!checkMinSumSel(h, sumSel, invSumAll, fracSel)) {
+        return false;
+    }
 
-        const auto& r = _reactions[h];
+    if (!checkOrdered(r, totals)) {
+        return false;
+    }
 
-        int sumSel = 0;
-        if (!checkEachElementPct(h, r, totals, invSumAll, sumSel)) {
-            continue;
-        }
+    return picks.offer(h, fracSel, _kByH[h]);
+}
 
-        float fracSel = 0.0f;
-        if (!checkMinSumSel(h, sumSel, invSumAll, fracSel)) {
-            continue;
+// Bit i of the result is set when lanes[i] passes minPctEach, minSumSelected and the ordered check; fracOut[i] gets
+// its selected fraction. Same float operations, in the same order, as the per-candidate checks. Only reached while
+// _batchEval is on, which needs AVX2 at runtime.
+#if defined(ERF_REACT_AVX2)
+ERF_TARGET_AVX2
+#endif
+std::uint32_t ReactionRegistry::evalRequirementLanes_(const std::int32_t* lanes, const std::int32_t* values,
+                                                      float invSumAll, float* fracOut) const {
+#if defined(ERF_REACT_AVX2)
+    const auto& R = _req;
+    const __m256i hv = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes));
+    const __m256 inv = _mm256_set1_ps(invSumAll);
+    const __m256 eps = _mm256_set1_ps(EPS);
+
+    __m256i sum = _mm256_setzero_si256();
+    __m256i first = sum;
+    __m256i above = sum;
+    __m256 bad = _mm256_setzero_ps();
+    for (std::size_t j = 0; j < kReqLanes; ++j) {
+        const __m256i e = _mm256_i32gather_epi32(R.elem.data() + j * R.stride, hv, 4);
+        const __m256i v = _mm256_i32gather_epi32(values, e, 4);
+        sum = _mm256_add_epi32(sum, v);
+        if (j == 0) {
+            first = v;
+        } else {
+            above = _mm256_or_si256(above, _mm256_cmpgt_epi32(v, first));
         }
+        const __m256 req = _mm256_i32gather_ps(R.minPct.data() + j * R.stride, hv, 4);
+        const __m256 p = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(v), inv), eps);
+        bad = _mm256_or_ps(bad, _mm256_cmp_ps(p, req, _CMP_LT_OQ));
+    }
 
-        if (!checkOrdered(r, totals)) {
-            continue;
-        }
+    const __m256 frac = _mm256_mul_ps(_mm256_cvtepi32_ps(sum), inv);
+    _mm256_store_ps(fracOut, frac);
 
-        const std::size_t k = _kByH[h];
-        if (!isBetterCandidate(h, fracSel, k, bestH, bestScore, bestK)) {
-            continue;
-        }
+    const __m256 minSum = _mm256_i32gather_ps(R.minSum.data(), hv, 4);
+    bad = _mm256_or_ps(bad, _mm256_cmp_ps(_mm256_add_ps(frac, eps), minSum, _CMP_LT_OQ));
 
-        bestScore = fracSel;
-        bestK = k;
-        bestH = h;
+    const __m256i ordered = _mm256_i32gather_epi32(R.ordered.data(), hv, 4);
+    bad = _mm256_or_ps(bad, _mm256_castsi256_ps(_mm256_and_si256(above, ordered)));
 
-        if (bestScore >= 1.0f - EPS) {
-            return;
-        }
-    }
+    return ~static_cast<std::uint32_t>(_mm256_movemask_ps(bad)) & ((1u << kReqBatch) - 1);
+#else
+    (void)lanes, (void)values, (void)invSumAll, (void)fracOut;
+    return 0;
+#endif
 }
 
-std::optional<ERF_ReactionHandle> ReactionRegistry::pickBest_core(std::span<const std::uint8_t> totals,
-                                                                  std::span<const ERF_ElementHandle> present,
-                                                                  float invSumAll, const ReactionRegistry* self,
-                                                                  const std::vector<bool>* used) {
-    self->buildIndex_();
-
-    Mask presentMask = 0;
-    for (auto h : present) {
-        if (!h) continue;
-        const auto bit = static_cast<unsigned>(h - 1);
-        if (bit < 64) presentMask |= (Mask(1) << bit);
+// Offers the passing members of hs in walk order; returns true once the pick set is settled.
+bool ReactionRegistry::evalBatch_(std::span<const ERF_ReactionHandle> hs, const std::int32_t* values,
+                                  std::span<const std::uint8_t> totals, float invSumAll, PickSet& picks) const {
+    // Padding lanes evaluate the reserved handle 0, whose lanes are all empty.
+    alignas(32) std::array<std::int32_t, kReqBatch> lanes{};
+    alignas(32) std::array<float, kReqBatch> frac{};
+    std::ranges::copy(hs, lanes.begin());
+
+    const auto pass = evalRequirementLanes_(lanes.data(), values, invSumAll, frac.data());
+
+    for (std::size_t i = 0; i < hs.size(); ++i) {
+        const auto h = hs[i];
+        const bool done = _req.wide[h] ? evalCandidate(h, totals, invSumAll, picks)
+                                       : ((pass >> i) & 1u) && picks.offer(h, frac[i], _kByH[h]);
+        if (done) return true;
     }
-    if (!presentMask) return std::nullopt;
+    return false;
+}
 
-    ERF_ReactionHandle bestH = 0;
-    float bestScore = 0.0f;
-    std::size_t bestK = 0;
+template <std::size_t Words>
+void ReactionRegistry::pickFrom_(const Index<Words>& ix, std::span<const std::uint8_t> totals,
+                                 std::span<const ERF_ElementHandle> present, float invSumAll, PickSet& picks) const {
+    auto visitOne = [&](ERF_ReactionHandle h) { return evalCandidate(h, totals, invSumAll, picks); };
+    if (!_batchEval) {
+        ix.forEachCandidate(makeMask_<Words>(present), visitOne);
+        return;
+    }
 
-    self->evalBucketForPickBest(presentMask, totals, invSumAll, used, bestH, bestScore, bestK);
-    if (bestH != 0 && bestScore >= 1.0f - 1e-6f) return bestH;
+    // The first candidates have the largest masks and usually settle the pick, so they go one by one. Past them,
+    // candidates queue up in walk order and go through the packed lanes eight at a time; a short tail is cheaper one
+    // by one, so the value lanes are only filled once a batch actually runs.
+    std::optional<PresentValues> values;
+    std::array<ERF_ReactionHandle, kReqBatch> pending{};
+    std::size_t nPending = 0;
+    std::size_t direct = 0;
+    bool done = false;
+
+    auto flush = [&] {
+        const std::span<const ERF_ReactionHandle> hs(pending.data(), std::exchange(nPending, 0));
+        if (hs.size() < kReqMinBatch) return std::ranges::any_of(hs, visitOne);
+        if (!values) values.emplace(_req.valueSlots, totals, present);
+        return evalBatch_(hs, values->data(), totals, invSumAll, picks);
+    };
+    ix.forEachCandidate(makeMask_<Words>(present), [&](ERF_ReactionHandle h) {
+        if (direct < kReqBatch) {
+            ++direct;
+            return done = visitOne(h);
+        }
+        pending[nPending++] = h;
+        done = nPending == kReqBatch && flush();
+        return done;
+    });
+    if (!done && nPending != 0) flush();
+}
 
-    for (auto sub = presentMask; sub; sub = (sub - 1) & presentMask) {
-        if (sub == presentMask) continue;
+void ReactionRegistry::pickBest_core(std::span<const std::uint8_t> totals, std::span<const ERF_ElementHandle> present,
+                                     float invSumAll, const ReactionRegistry* self, PickSet& picks) {
+    self->buildIndex_();
 
-        self->evalBucketForPickBest(sub, totals, invSumAll, used, bestH, bestScore, bestK);
-        if (bestH != 0 && bestScore >= 1.0f - 1e-6f) break;
+    if (const auto* narrow = std::get_if<Index<1>>(&self->_index)) {
+        self->pickFrom_(*narrow, totals, present, invSumAll, picks);
+        return;
     }
+    std::visit([&](const auto& ix) { self->pickFrom_(ix, totals, present, invSumAll, picks); }, self->_index);
+}
 
-    if (bestH == 0) return std::nullopt;
-    return bestH;
+ERF_PickBestInfo ReactionRegistry::pickInfo_(ERF_ReactionHandle h) const {
+    const ERF_ReactionDesc& d = _reactions[h];
+    ERF_PickBestInfo info;
+    info.handle = h;
+    info.colorRGB = d.Tint;
+    info.icon = d.iconName.empty() ? nullptr : d.iconName.c_str();
+    return info;
 }
 
 std::optional<ERF_PickBestInfo> ReactionRegistry::pickBestFast(std::span<const std::uint8_t> totals,
@@ -248,44 +568,26 @@ std::optional<ERF_PickBestInfo> ReactionRegistry::pickBestFast(std::span<const s
                                                                float invSumAll) const {
     if (sumAll <= 0) return std::nullopt;
 
-    auto rh = pickBest_core(totals, present, invSumAll, this);
-    if (!rh.has_value()) return std::nullopt;
-
-    const ERF_ReactionDesc* d = get(*rh);
-    if (!d) return std::nullopt;
+    PickSet picks(1);
+    pickBest_core(totals, present, invSumAll, this, picks);
 
-    ERF_PickBestInfo info;
-    info.handle = *rh;
-    info.colorRGB = d->Tint;
-    info.icon = d->iconName.empty() ? nullptr : d->iconName.c_str();
-    return info;
+    const auto best = picks.sorted();
+    if (best.empty() || !get(best.front().h)) return std::nullopt;
+    return pickInfo_(best.front().h);
 }
 
+// One walk for any maxCount: every candidate is scored once and the set keeps the maxCount best, in the order the
+// repeated single picks used to return them.
 void ReactionRegistry::pickBestFastMulti(std::span<const std::uint8_t> totals,
                                          std::span<const ERF_ElementHandle> present, int sumAll, float invSumAll,
                                          int maxCount, std::vector<ERF_PickBestInfo>& out) const {
     out.clear();
     if (sumAll <= 0 || maxCount <= 0) return;
 
-    std::vector<bool> used(_reactions.size(), false);
-
-    while (maxCount-- > 0) {
-        auto rh = pickBest_core(totals, present, invSumAll, this, &used);
-        if (!rh.has_value()) break;
+    PickSet picks(static_cast<std::size_t>(maxCount));
+    pickBest_core(totals, present, invSumAll, this, picks);
 
-        const ERF_ReactionDesc* d = get(*rh);
-
-        if (*rh < used.size()) {
-            used[*rh] = true;
-        }
-
-        if (!d) continue;
-
-        ERF_PickBestInfo info;
-        info.handle = *rh;
-        info.colorRGB = d->Tint;
-        info.icon = d->iconName.empty() ? nullptr : d->iconName.c_str();
-
-        out.push_back(info);
+    for (const auto& p : picks.sorted()) {
+        if (get(p.h)) out.push_back(pickInfo_(p.h));
     }
-}
\ No newline at end of file
+}
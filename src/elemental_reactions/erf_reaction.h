@@ -1,12 +1,12 @@
 #pragma once
 
-#include <ankerl/unordered_dense.h>
-
 #include <cstdint>
 #include <optional>
 #include <span>
+#include <variant>
 #include <vector>
 
+#include "ElementMask.h"
 #include "RE/Skyrim.h"
 #include "erf_element.h"
 
@@ -39,6 +39,51 @@ struct ERF_PickBestInfo {
     const char* icon{nullptr};
 };
 
+// Reaction candidates by element mask, in pick priority (larger masks first, then lower handles). When every used
+// element fits in kDenseMaxBits, a decision table lists the candidates for each present mask directly; otherwise
+// reactions are bucketed by their highest element and checked against the present mask one bucket at a time.
+template <std::size_t Words>
+struct ERF_ReactionIndex {
+    using Mask = ElementMask<Words>;
+
+    static constexpr unsigned kDenseMaxBits = 12;
+    static constexpr std::size_t kDenseMaxEntries = std::size_t{1} << 18;
+
+    std::vector<Mask> maskByH;
+
+    unsigned denseBits = 0;
+    std::vector<std::uint32_t> denseStart;
+    std::vector<ERF_ReactionHandle> dense;
+
+    std::vector<std::uint32_t> highStart;
+    std::vector<ERF_ReactionHandle> byHighBit;
+    std::vector<Mask> byHighBitMask;
+
+    // masks[h] holds the elements of reaction h; handle 0 and reactions without elements are never candidates.
+    void build(std::span<const Mask> masks);
+
+    // Calls visit(h) for every reaction whose elements are all present, in priority order, until visit returns true.
+    template <class F>
+    void forEachCandidate(const Mask& present, F&& visit) const {
+        if (!present.any()) return;
+
+        bool done = false;
+        if (denseBits) {
+            const auto pm = present.w[0] & ((std::uint64_t{1} << denseBits) - 1);
+            for (auto i = denseStart[pm]; i < denseStart[pm + 1] && !done; ++i) done = visit(dense[i]);
+            return;
+        }
+        for (auto rest = present; rest.any() && !done;) {
+            const auto b = static_cast<std::size_t>(rest.highBit());
+            rest.reset(b);
+            for (auto i = highStart[b]; i < highStart[b + 1] && !done; ++i) {
+                if (!byHighBitMask[i].subsetOf(present)) continue;
+                done = visit(byHighBit[i]);
+            }
+        }
+    }
+};
+
 class ReactionRegistry {
 public:
     static ReactionRegistry& get();
@@ -52,30 +97,65 @@ public:
     std::size_t size() const noexcept;
     void freeze();
     bool isFrozen() const noexcept { return _indexed; }
+    // Evaluates candidates eight at a time against the packed requirement lanes with AVX2 gathers; off walks one
+    // candidate at a time through the descriptors. Defaults to on when the CPU has AVX2, and stays off without it
+    // whatever is asked. Exists for A/B runs in the bench.
+    static void setBatchEval(bool on) noexcept;
+    static bool batchEval() noexcept { return _batchEval; }
 
 private:
     ReactionRegistry() = default;
     std::vector<ERF_ReactionDesc> _reactions;
 
-    using Mask = std::uint64_t;
-
     mutable bool _indexed = false;
-    mutable std::vector<Mask> _maskByH;
     mutable std::vector<std::uint8_t> _kByH;
     mutable std::vector<std::uint32_t> _minTotalByH;
     mutable std::vector<float> _minPctEachByH;
     mutable std::vector<float> _minSumSelByH;
-    mutable ankerl::unordered_dense::map<Mask, std::vector<ERF_ReactionHandle>> _byMask;
+
+    // Requirements packed at freeze() so a batch of candidates is checked with gathers instead of walking each
+    // descriptor. Lane j of reaction h lives at [j * stride + h]; unused lanes point at element 0 with no threshold.
+    // Reactions with more than kReqLanes elements are flagged wide and take the per-candidate path.
+    static constexpr std::size_t kReqLanes = 4;
+    static constexpr std::size_t kReqBatch = 8;
+    static constexpr std::size_t kReqMinBatch = 8;
+    struct RequirementLanes {
+        std::size_t stride = 0;
+        std::size_t valueSlots = 0;
+        std::vector<std::int32_t> elem;
+        std::vector<float> minPct;
+        std::vector<float> minSum;
+        std::vector<std::int32_t> ordered;
+        std::vector<std::uint8_t> wide;
+    };
+    mutable RequirementLanes _req;
+    static bool _batchEval;
+
+    template <std::size_t Words>
+    using Index = ERF_ReactionIndex<Words>;
+    using AnyIndex = std::variant<Index<1>, Index<2>, Index<4>, Index<kMaxMaskWords>>;
+
+    mutable AnyIndex _index;
 
     void buildIndex_() const;
-    static Mask makeMask_(const std::vector<ERF_ElementHandle>& elems);
-    static std::optional<ERF_ReactionHandle> pickBest_core(std::span<const std::uint8_t> totals,
-                                                           std::span<const ERF_ElementHandle> present, float invSumAll,
-                                                           const ReactionRegistry* self,
-                                                           const std::vector<bool>* used = nullptr);
-    void evalBucketForPickBest(Mask m, std::span<const std::uint8_t> totals, float invSumAll,
-                               const std::vector<bool>* used, ERF_ReactionHandle& bestH, float& bestScore,
-                               std::size_t& bestK) const;
+    void buildRequirementLanes_(std::size_t maxElem) const;
+    template <std::size_t Words>
+    void buildDecisionTable_(Index<Words>& ix) const;
+    template <std::size_t Words>
+    static ElementMask<Words> makeMask_(std::span<const ERF_ElementHandle> elems);
+    class PickSet;
+    static void pickBest_core(std::span<const std::uint8_t> totals, std::span<const ERF_ElementHandle> present,
+                              float invSumAll, const ReactionRegistry* self, PickSet& picks);
+    template <std::size_t Words>
+    void pickFrom_(const Index<Words>& ix, std::span<const std::uint8_t> totals,
+                   std::span<const ERF_ElementHandle> present, float invSumAll, PickSet& picks) const;
+    bool evalCandidate(ERF_ReactionHandle h, std::span<const std::uint8_t> totals, float invSumAll,
+                       PickSet& picks) const;
+    std::uint32_t evalRequirementLanes_(const std::int32_t* lanes, const std::int32_t* values, float invSumAll,
+                                        float* fracOut) const;
+    bool evalBatch_(std::span<const ERF_ReactionHandle> hs, const std::int32_t* values,
+                    std::span<const std::uint8_t> totals, float invSumAll, PickSet& picks) const;
+    ERF_PickBestInfo pickInfo_(ERF_ReactionHandle h) const;
     bool checkMinSumSel(ERF_ReactionHandle h, int sumSel, float invSumAll, float& fracSelOut) const;
 
     bool checkEachElementPct(ERF_ReactionHandle h, const ERF_ReactionDesc& r, std::span<const std::uint8_t> totals,
@@ -1,5 +1,34 @@
 #include "erf_state.h"
 
+#include <algorithm>
+#include <bit>
+
+#include "erf_element.h"
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define ERF_STATE_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define ERF_STATE_SSE2 1
+#endif
+
+namespace {
+    void mulRow(float* out, const float* row, std::size_t n) noexcept {
+        std::size_t i = 0;
+#if defined(ERF_STATE_AVX)
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(out + i), _mm256_load_ps(row + i)));
+        }
+#elif defined(ERF_STATE_SSE2)
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(out + i), _mm_load_ps(row + i)));
+        }
+#endif
+        for (; i < n; ++i) out[i] *= row[i];
+    }
+}
+
 StateRegistry& StateRegistry::get() {
     static StateRegistry R;
     if (R._states.empty()) R._states.resize(1);
@@ -57,6 +86,12 @@ void StateRegistry::setElementMultipliers(  // NOSONAR - this method intentional
 
     row[ei].gaugeMult = gaugeMult;
     row[ei].healthMult = healthMult;
+
+    if (R._matrix && si < R._rows && ei < R._stride) {
+        R.gaugePlane_()[si * R._stride + ei] = static_cast<float>(gaugeMult);
+        R.healthPlane_()[si * R._stride + ei] = static_cast<float>(healthMult);
+    }
+    R._multGen.fetch_add(1, std::memory_order_release);
 }
 
 double StateRegistry::getGaugeMultiplier(ERF_StateHandle state, std::uint16_t elemHandle) const {
@@ -81,9 +116,52 @@ void StateRegistry::freeze() {
         if (!s.name.empty()) _nameIndex.emplace(std::string_view{s.name}, h);
         if (s.keyword) _kwIndex.emplace(s.keyword->GetFormID(), h);
     }
+    buildMatrix_();
     _frozen = true;
 }
 
+void StateRegistry::buildMatrix_() {
+    _rows = _states.size();
+    _stride = (ElementRegistry::get().size() + 1 + 15) & ~std::size_t{15};
+    _matrix.reset(static_cast<float*>(::operator new[](2 * _rows * _stride * sizeof(float), std::align_val_t{64})));
+    std::fill_n(_matrix.get(), 2 * _rows * _stride, 1.0f);
+
+    for (std::size_t si = 1; si < _rows && si < _perElementMult.size(); ++si) {
+        const auto& row = _perElementMult[si];
+        for (std::size_t ei = 1; ei < row.size() && ei < _stride; ++ei) {
+            gaugePlane_()[si * _stride + ei] = static_cast<float>(row[ei].gaugeMult);
+            healthPlane_()[si * _stride + ei] = static_cast<float>(row[ei].healthMult);
+        }
+    }
+    _multGen.fetch_add(1, std::memory_order_release);
+}
+
+void StateRegistry::productOver(std::span<const std::uint64_t> activeMask, std::span<float> gaugeOut,
+                                std::span<float> healthOut) const {
+    const std::size_t n = std::min(gaugeOut.size(), healthOut.size());
+    std::fill_n(gaugeOut.data(), n, 1.0f);
+    std::fill_n(healthOut.data(), n, 1.0f);
+
+    for (std::size_t w = 0; w < activeMask.size(); ++w) {
+        for (auto bits = activeMask[w]; bits; bits &= bits - 1) {
+            const std::size_t sh = w * 64 + static_cast<std::size_t>(std::countr_zero(bits)) + 1;
+
+            if (_matrix && sh < _rows) {
+                const std::size_t m = std::min(n, _stride);
+                mulRow(gaugeOut.data(), gaugePlane_() + sh * _stride, m);
+                mulRow(healthOut.data(), healthPlane_() + sh * _stride, m);
+                continue;
+            }
+            const auto state = static_cast<ERF_StateHandle>(sh);
+            for (std::size_t e = 1; e < n; ++e) {
+                const auto mult = getElementMultipliers(state, static_cast<std::uint16_t>(e));
+                gaugeOut[e] *= static_cast<float>(mult.gaugeMult);
+                healthOut[e] *= static_cast<float>(mult.healthMult);
+            }
+        }
+    }
+}
+
 const ERF_StateDesc* StateRegistry::get(ERF_StateHandle h) const {
     if (h == 0) return nullptr;
     if (static_cast<std::size_t>(h) >= _states.size()) return nullptr;
@@ -1,8 +1,13 @@
 #pragma once
 #include <ankerl/unordered_dense.h>
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <new>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -36,6 +41,8 @@ public:
     void freeze();
     bool isFrozen() const noexcept { return _frozen; }
 
+    // After freeze this writes through to the matrix productOver reads; callers serialize the two (ElementalStates
+    // does both under its store lock).
     void setElementMultipliers(ERF_StateHandle state, std::uint16_t elemHandle, double gaugeMult, double healthMult);
 
     ERF_StateElementMult getElementMultipliers(ERF_StateHandle state, std::uint16_t elemHandle) const;
@@ -43,6 +50,16 @@ public:
     double getGaugeMultiplier(ERF_StateHandle state, std::uint16_t elemHandle) const;
     double getHealthMultiplier(ERF_StateHandle state, std::uint16_t elemHandle) const;
 
+    // Bumped after every multiplier write; a reader that sees a new value also sees the matrix it guards.
+    std::uint32_t multipliersGeneration() const noexcept { return _multGen.load(std::memory_order_acquire); }
+
+    // Row width of the frozen state x element matrix (element handles 0..N, padded to 16 floats); 0 before freeze.
+    std::size_t elementStride() const noexcept { return _stride; }
+
+    // out[e] = product of the multipliers of every state whose bit (h - 1) is set in activeMask.
+    void productOver(std::span<const std::uint64_t> activeMask, std::span<float> gaugeOut,
+                     std::span<float> healthOut) const;
+
 private:
     StateRegistry() = default;
     std::vector<ERF_StateDesc> _states;
@@ -50,4 +67,16 @@ private:
     ankerl::unordered_dense::map<std::string_view, ERF_StateHandle> _nameIndex;
     ankerl::unordered_dense::map<RE::FormID, ERF_StateHandle> _kwIndex;
     std::vector<std::vector<ERF_StateElementMult>> _perElementMult;
+    std::atomic<std::uint32_t> _multGen{1};
+
+    struct AlignedFree {
+        void operator()(float* p) const noexcept { ::operator delete[](p, std::align_val_t{64}); }
+    };
+    std::unique_ptr<float[], AlignedFree> _matrix;
+    std::size_t _stride = 0;
+    std::size_t _rows = 0;
+
+    void buildMatrix_();
+    float* gaugePlane_() const noexcept { return _matrix.get(); }
+    float* healthPlane_() const noexcept { return _matrix.get() + _rows * _stride; }
 };
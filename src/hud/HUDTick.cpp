@@ -2,196 +2,344 @@
 
 #include <algorithm>
 #include <chrono>
-#include <condition_variable>
-#include <mutex>
-#include <thread>
 #include <unordered_map>
-#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "../Config.h"
 #include "../elemental_reactions/ElementalGauges.h"
+#include "../elemental_reactions/ElementalStates.h"
 #include "InjectHUD.h"
 #include "RE/Skyrim.h"
+#include "REL/Relocation.h"
 #include "SKSE/SKSE.h"
 
 namespace {
-    static std::atomic_bool g_run{false};
-    static std::condition_variable g_cv;
-    static std::mutex g_cv_m;
+    using SteadyClock = std::chrono::steady_clock;
 
-    static std::atomic<int> g_fastMs{16};
-    static std::atomic<int> g_slowMs{50};
-    static std::atomic<int> g_periodMs{16};
-    static std::atomic<int> g_idleFrames{0};
-    static constexpr int kIdleThreshold = 30;
+    enum class Tier : std::uint8_t { kPlayer, kTarget, kOnScreen, kOffScreen };
+
+    struct Track {
+        float addedAt{0.0f};
+        float lastSeen{0.0f};
+        std::uint32_t seenPass{0};
+        Tier tier{Tier::kOnScreen};
+    };
 
+    struct Candidate {
+        RE::Actor* actor{nullptr};
+        RE::FormID id{0};
+    };
+
+    static std::atomic_bool g_run{false};
     static std::atomic_bool g_wake{false};
+    static std::atomic<long long> g_lastArmMs{0};
 
-    static std::atomic_bool g_lastHadWork{false};
-    std::unordered_map<RE::FormID, float> lastSeen;
+    static constexpr int kIdleThreshold = 30;
+    static constexpr double kIdlePeriodS = 0.05;
+    static constexpr double kSweepPeriodS = 0.1;
+    static constexpr long long kArmTimeoutMs = 15000;
+    static constexpr double kStoreSweepPeriodS = 10.0;
 
-    std::unordered_map<RE::FormID, float> lastAddedAt;
     constexpr float INIT_GRACE_SECONDS = 0.05f;
+    constexpr float ZERO_GRACE_SECONDS = 0.1f;
     static constexpr float EVICT_SECONDS = 10.0f;
 
-    void UpdateAllOnUIThread() {
-        const double nowRt = InjectHUD::NowRtS();
-        const float nowH = RE::Calendar::GetSingleton()->GetHoursPassed();
+    // Everything below is only touched from the HUD menu's AdvanceMovie, i.e. the UI thread.
+    std::unordered_map<RE::FormID, Track> g_track;
+    std::vector<Candidate> g_candidates;
+    std::vector<RE::Actor*> g_cullActors;
+    std::vector<std::uint32_t> g_visible;
+    std::vector<Candidate> g_onScreen;
+    std::vector<RE::FormID> g_toRemove;
+    std::size_t g_onCursor = 0;
+    std::uint32_t g_pass = 0;
+    int g_idleFrames = 0;
+    double g_lastPassRt = 0.0;
+    double g_lastSweepRt = 0.0;
+    double g_lastStoreSweepRt = 0.0;
+    bool g_lastHadWork = false;
+
+    static std::atomic<float> g_costLastUs{0.f};
+    static std::atomic<float> g_costAvgUs{0.f};
+    static std::atomic<float> g_costPeakUs{0.f};
+    static std::atomic<std::uint32_t> g_costUpdated{0};
+    static std::atomic<std::uint32_t> g_costDeferred{0};
+    static std::atomic<std::uint32_t> g_costCulled{0};
+
+    long long SteadyMs() {
+        using namespace std::chrono;
+        return duration_cast<milliseconds>(SteadyClock::now().time_since_epoch()).count();
+    }
+
+    long long ElapsedUs(SteadyClock::time_point t0) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - t0).count();
+    }
+
+    RE::FormID CombatTargetOf(RE::PlayerCharacter* pc) {
+        if (!pc) return 0;
+        const auto target = pc->GetActorRuntimeData().currentCombatTarget.get();
+        return target ? target->GetFormID() : 0;
+    }
+
+    RE::Actor* ResolveActor(RE::FormID id) {
+        auto& st = InjectHUD::Globals();
+        if (auto itW = st.widgets.find(id); itW != st.widgets.end() && itW->second.handle) {
+            if (auto* a = itW->second.handle.get().get()) return a;
+        }
+        auto* a = RE::TESForm::LookupByID<RE::Actor>(id);
+        if (a) {
+            auto& entry = st.widgets.try_emplace(id).first->second;
+            entry.handle = a->CreateRefHandle();
+        }
+        return a;
+    }
+
+    void Forget(RE::FormID id) {
+        g_toRemove.push_back(id);
+        g_track.erase(id);
+    }
+
+    void HideOnce(RE::FormID id, Track& t) {
+        if (t.tier != Tier::kOffScreen) {
+            InjectHUD::HideFor(id);
+            t.tier = Tier::kOffScreen;
+        }
+    }
+
+    // On-screen widgets get their full update, widgets that just left the screen are hidden once.
+    void Visit(const Candidate& c, Track& t, Tier onScreenTier, float now, double nowRt, float nowH) {
+        if (InjectHUD::IsOnScreen(c.actor)) {
+            t.tier = onScreenTier;
+            if (now - t.addedAt >= INIT_GRACE_SECONDS) {
+                InjectHUD::UpdateFor(c.actor, nowRt, nowH);
+            }
+            return;
+        }
+        HideOnce(c.id, t);
+    }
+
+    // Widgets whose actor has no live gauge any more: hide after a short grace, evict after EVICT_SECONDS.
+    void SweepIdle(float now) {
+        auto& st = InjectHUD::Globals();
+        for (const auto& [id, entry] : st.widgets) {
+            auto it = g_track.find(id);
+            if (it != g_track.end() && it->second.seenPass == g_pass) continue;
+
+            const float age = now - (it != g_track.end() ? it->second.lastSeen : 0.0f);
+            if (age >= ZERO_GRACE_SECONDS && (it == g_track.end() || it->second.tier != Tier::kOffScreen)) {
+                InjectHUD::HideFor(id);
+                if (it != g_track.end()) it->second.tier = Tier::kOffScreen;
+            }
+            if (age >= EVICT_SECONDS) {
+                g_toRemove.push_back(id);
+            }
+        }
+
+        for (auto it = g_track.begin(); it != g_track.end();) {
+            const bool aliveNow = it->second.seenPass == g_pass;
+            const bool hasEntry = st.widgets.contains(it->first);
+            const float age = now - it->second.lastSeen;
+            if (!aliveNow && (age >= EVICT_SECONDS || (!hasEntry && age >= ZERO_GRACE_SECONDS))) {
+                it = g_track.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void RunPass(double nowRt, float nowH, SteadyClock::time_point t0, long long budgetUs) {
         InjectHUD::OnUIFrameBegin(nowRt, nowH);
 
-        if (auto const* pc = RE::PlayerCharacter::GetSingleton(); pc && pc->IsDead()) {
+        auto* pc = RE::PlayerCharacter::GetSingleton();
+        if (pc && pc->IsDead()) {
             InjectHUD::RemoveAllWidgets();
             HUD::ResetTracking();
+            g_lastHadWork = false;
             return;
         }
 
         const float now = RE::Calendar::GetSingleton()->GetCurrentGameTime() * 3600.0f;
+        const RE::FormID targetID = CombatTargetOf(pc);
 
-        constexpr float ZERO_GRACE_SECONDS = 0.1f;
+        ++g_pass;
+        g_candidates.clear();
+        g_onScreen.clear();
+        g_toRemove.clear();
 
-        std::unordered_set<RE::FormID> alive;
-        alive.reserve(64);
-
-        std::vector<RE::FormID> toRemove;
-        toRemove.reserve(16);
+        std::uint32_t updated = 0;
+        bool anyAlive = false;
 
         ElementalGauges::ForEachDecayed([&](RE::FormID id, ElementalGauges::TotalsView) {
-            alive.insert(id);
+            anyAlive = true;
 
-            RE::Actor* a = nullptr;
-            auto& st = InjectHUD::Globals();
-            if (auto itW = st.widgets.find(id); itW != st.widgets.end()) {
-                a = (itW->second.handle) ? itW->second.handle.get().get() : nullptr;
-            }
-            if (!a) {
-                a = RE::TESForm::LookupByID<RE::Actor>(id);
-                if (a) {
-                    auto [__itW, __insertedW] = st.widgets.try_emplace(id);
-                    auto& entry = __itW->second;
-                    entry.handle = a->CreateRefHandle();
-                }
-            }
-
-            if (!a) {
-                toRemove.push_back(id);
-                lastAddedAt.erase(id);
-                lastSeen.erase(id);
-                return;
-            }
-
-            if (a->IsDead()) {
-                toRemove.push_back(id);
-                lastAddedAt.erase(id);
-                lastSeen.erase(id);
+            RE::Actor* a = ResolveActor(id);
+            if (!a || a->IsDead()) {
+                Forget(id);
                 return;
             }
 
             InjectHUD::AddFor(a);
 
-            auto [itAdd, inserted] = lastAddedAt.try_emplace(id, now);
-            const bool inGrace = inserted || ((now - itAdd->second) < INIT_GRACE_SECONDS);
+            auto [it, inserted] = g_track.try_emplace(id);
+            auto& t = it->second;
+            if (inserted) t.addedAt = now;
+            t.lastSeen = now;
+            t.seenPass = g_pass;
 
-            if (!InjectHUD::IsOnScreen(a)) {
-                InjectHUD::HideFor(id);
-            } else if (!inGrace) {
-                InjectHUD::UpdateFor(a, nowRt, nowH);
+            if (a->IsPlayerRef() || id == targetID) {
+                Visit({a, id}, t, a->IsPlayerRef() ? Tier::kPlayer : Tier::kTarget, now, nowRt, nowH);
+                ++updated;
+            } else {
+                g_candidates.push_back({a, id});
             }
-
-            lastSeen[id] = now;
         });
 
-        auto& st = InjectHUD::Globals();
-        for (auto it = st.widgets.begin(); it != st.widgets.end(); ++it) {
-            const RE::FormID id = it->first;
-            const bool isAlive = (alive.find(id) != alive.end());
-
-            if (!isAlive) {
-                const float seen = lastSeen.contains(id) ? lastSeen[id] : 0.0f;
-                const float age = now - seen;
-
-                if (age >= ZERO_GRACE_SECONDS) {
-                    InjectHUD::HideFor(id);
-                }
-
-                if (age >= EVICT_SECONDS) {
-                    toRemove.push_back(id);
-                    lastAddedAt.erase(id);
-                    lastSeen.erase(id);
-                }
+        // Everyone else is projected in one batch; actors outside the view, too far away or beyond the closest
+        // MaxVisible are hidden without any widget work.
+        const auto& cfg = ERF::GetConfig();
+        g_cullActors.clear();
+        for (const auto& c : g_candidates) g_cullActors.push_back(c.actor);
+        const RE::NiPoint3 origin = pc ? pc->GetPosition() : RE::NiPoint3{};
+        InjectHUD::CullTracked(g_cullActors, origin, cfg.hudMaxDistance.load(std::memory_order_relaxed),
+                               static_cast<std::size_t>(std::max(0, cfg.hudMaxVisible.load(std::memory_order_relaxed))),
+                               g_visible);
+
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < g_candidates.size(); ++i) {
+            const auto& c = g_candidates[i];
+            if (next < g_visible.size() && g_visible[next] == i) {
+                g_onScreen.push_back(c);
+                ++next;
+            } else {
+                HideOnce(c.id, g_track[c.id]);
             }
         }
-
-        if (!toRemove.empty()) {
-            for (auto id : toRemove) {
-                InjectHUD::RemoveFor(id);
+        const auto culled = static_cast<std::uint32_t>(g_candidates.size() - g_onScreen.size());
+
+        // The player and the current target are always refreshed. On-screen widgets share what is left of the
+        // budget, starting where the previous frame stopped so nobody starves; at least one is always visited.
+        const auto overBudget = [&] { return budgetUs > 0 && ElapsedUs(t0) >= budgetUs; };
+        std::uint32_t deferred = 0;
+
+        if (const auto n = g_onScreen.size(); n != 0) {
+            const std::size_t start = g_onCursor % n;
+            std::size_t done = 0;
+            for (; done < n; ++done) {
+                if (done != 0 && overBudget()) break;
+                const auto& c = g_onScreen[(start + done) % n];
+                Visit(c, g_track[c.id], Tier::kOnScreen, now, nowRt, nowH);
             }
+            g_onCursor = start + done;
+            updated += static_cast<std::uint32_t>(done);
+            deferred += static_cast<std::uint32_t>(n - done);
         }
 
-        for (auto it = lastSeen.begin(); it != lastSeen.end();) {
-            const RE::FormID id = it->first;
-            const bool hasEntry = (st.widgets.find(id) != st.widgets.end());
-            const bool aliveNow = (alive.find(id) != alive.end());
-            const float age = now - it->second;
+        if (nowRt - g_lastSweepRt >= kSweepPeriodS) {
+            g_lastSweepRt = nowRt;
+            SweepIdle(now);
+        }
 
-            if (!aliveNow && !hasEntry && age >= ZERO_GRACE_SECONDS) {
-                lastAddedAt.erase(id);
-                it = lastSeen.erase(it);
-            } else {
-                ++it;
-            }
+        for (auto id : g_toRemove) {
+            InjectHUD::RemoveFor(id);
         }
 
-        const bool hadWork = !alive.empty() || !st.widgets.empty();
-        g_lastHadWork.store(hadWork, std::memory_order_relaxed);
+        g_lastHadWork = anyAlive || !InjectHUD::Globals().widgets.empty();
+        g_costUpdated.store(updated, std::memory_order_relaxed);
+        g_costDeferred.store(deferred, std::memory_order_relaxed);
+        g_costCulled.store(culled, std::memory_order_relaxed);
     }
-}
 
-void HUD::StartHUDTick() {
-    if (g_run.exchange(true)) {
-        g_wake.store(true, std::memory_order_relaxed);
-        g_periodMs.store(g_fastMs.load(std::memory_order_relaxed), std::memory_order_relaxed);
-        g_cv.notify_one();
-        return;
+    void RecordCost(float us) {
+        g_costLastUs.store(us, std::memory_order_relaxed);
+        const float avg = g_costAvgUs.load(std::memory_order_relaxed);
+        g_costAvgUs.store(avg + (us - avg) * 0.05f, std::memory_order_relaxed);
+        const float peak = g_costPeakUs.load(std::memory_order_relaxed) * 0.99f;
+        g_costPeakUs.store(std::max(us, peak), std::memory_order_relaxed);
     }
 
-    std::thread([] {
-        using namespace std::chrono;
+    // Returns whether a HUD pass ran this frame.
+    bool TickHud(double nowRt) {
+        if (!g_run.load(std::memory_order_acquire)) return false;
 
-        for (;;) {
-            int waitMs = g_periodMs.load(std::memory_order_relaxed);
-            {
-                std::unique_lock lk(g_cv_m);
-                g_cv.wait_for(lk, milliseconds(waitMs), [] { return !g_run.load() || g_wake.load(); });
-                g_wake.store(false, std::memory_order_relaxed);
-            }
-            if (!g_run.load(std::memory_order_relaxed)) break;
+        const bool woken = g_wake.exchange(false, std::memory_order_relaxed);
+        if (!woken && !g_lastHadWork && SteadyMs() - g_lastArmMs.load(std::memory_order_relaxed) > kArmTimeoutMs) {
+            g_run.store(false, std::memory_order_relaxed);
+            return false;
+        }
 
-            if (auto* ti = SKSE::GetTaskInterface()) {
-                ti->AddUITask([] { UpdateAllOnUIThread(); });
-            }
+        if (!woken && g_idleFrames >= kIdleThreshold && nowRt - g_lastPassRt < kIdlePeriodS) return false;
+        g_lastPassRt = nowRt;
 
-            const bool hadWork = g_lastHadWork.load(std::memory_order_relaxed);
-            if (hadWork) {
-                g_idleFrames.store(0, std::memory_order_relaxed);
-                g_periodMs.store(g_fastMs.load(std::memory_order_relaxed), std::memory_order_relaxed);
-            } else {
-                int idle = g_idleFrames.load(std::memory_order_relaxed) + 1;
-                g_idleFrames.store(idle, std::memory_order_relaxed);
-                if (idle >= kIdleThreshold) {
-                    g_periodMs.store(g_slowMs.load(std::memory_order_relaxed), std::memory_order_relaxed);
-                }
-            }
+        const auto t0 = SteadyClock::now();
+        const long long budgetUs = ERF::GetConfig().hudFrameBudgetUs.load(std::memory_order_relaxed);
+        RunPass(nowRt, RE::Calendar::GetSingleton()->GetHoursPassed(), t0, budgetUs);
+        RecordCost(static_cast<float>(ElapsedUs(t0)));
+
+        g_idleFrames = g_lastHadWork ? 0 : g_idleFrames + 1;
+        return true;
+    }
+
+    // Decay-only eviction happens as a side effect of HUD passes and hits, so with the HUD off or nobody being hit
+    // the stores would keep dead and drained actors forever. Runs on a frame without a HUD pass when one is due,
+    // or regardless once it is several periods late.
+    void SweepStores(double nowRt, bool passRan) {
+        const double since = nowRt - g_lastStoreSweepRt;
+        if (since < kStoreSweepPeriodS || (passRan && since < kStoreSweepPeriodS * 4.0)) return;
+        g_lastStoreSweepRt = nowRt;
+        ElementalGauges::Compact();
+        ElementalStates::Compact();
+    }
+
+    void OnFrame() {
+        const double nowRt = InjectHUD::NowRtS();
+        SweepStores(nowRt, TickHud(nowRt));
+    }
+
+    struct AdvanceMovieHook {
+        static constexpr std::size_t kIndex = 0x05;
+        using Fn = void(RE::HUDMenu*, float, std::uint32_t);
+        static inline Fn* _orig{};
+
+        static void thunk(RE::HUDMenu* self, float interval, std::uint32_t currentTime) {
+            _orig(self, interval, currentTime);
+            OnFrame();
         }
-    }).detach();
+
+        static void Install() {
+            REL::Relocation<std::uintptr_t> vtbl{RE::HUDMenu::VTABLE[0]};
+            const auto old = vtbl.write_vfunc(kIndex, &thunk);
+            _orig = reinterpret_cast<Fn*>(old);
+        }
+    };
+}
+
+void HUD::InstallFrameHook() {
+    static bool installed = false;
+    if (std::exchange(installed, true)) return;
+    AdvanceMovieHook::Install();
+}
+
+void HUD::StartHUDTick() {
+    g_lastArmMs.store(SteadyMs(), std::memory_order_relaxed);
+    g_wake.store(true, std::memory_order_relaxed);
+    g_run.store(true, std::memory_order_release);
 }
 
 void HUD::StopHUDTick() {
     g_run.store(false, std::memory_order_relaxed);
-    g_wake.store(true, std::memory_order_relaxed);
-    g_cv.notify_one();
+    g_wake.store(false, std::memory_order_relaxed);
 }
 
 void HUD::ResetTracking() {
-    lastSeen.clear();
-    lastAddedAt.clear();
+    g_track.clear();
+    g_candidates.clear();
+    g_onScreen.clear();
+    g_onCursor = 0;
+}
+
+HUD::FrameCost HUD::GetFrameCost() noexcept {
+    return FrameCost{g_costLastUs.load(std::memory_order_relaxed), g_costAvgUs.load(std::memory_order_relaxed),
+                     g_costPeakUs.load(std::memory_order_relaxed), g_costUpdated.load(std::memory_order_relaxed),
+                     g_costDeferred.load(std::memory_order_relaxed), g_costCulled.load(std::memory_order_relaxed)};
 }
@@ -1,8 +1,20 @@
 #pragma once
 #include <atomic>
+#include <cstdint>
 
 namespace HUD {
+    struct FrameCost {
+        float lastUs{0.f};
+        float avgUs{0.f};
+        float peakUs{0.f};
+        std::uint32_t updated{0};
+        std::uint32_t deferred{0};
+        std::uint32_t culled{0};
+    };
+
+    void InstallFrameHook();
     void StartHUDTick();
     void StopHUDTick();
     void ResetTracking();
-}
\ No newline at end of file
+    FrameCost GetFrameCost() noexcept;
+}
@@ -4,6 +4,7 @@
 #include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <immintrin.h>
 #include <memory>
 #include <string_view>
 #include <vector>
@@ -23,6 +24,127 @@ namespace {
     using namespace InjectHUD;
 
     static thread_local HUDFrameSnapshot g_snap{};
+    static thread_local std::uint32_t g_layoutEpoch{1};
+
+    // Anchor position and screen projection, resolved once per actor per HUD frame. IsOnScreen and
+    // FollowActorHead both read it instead of each walking the skeleton and projecting again.
+    struct ScreenProj {
+        std::uint32_t frame{0};
+        bool valid{false};
+        float nx{0.f};
+        float ny{0.f};
+        float depth{0.f};
+
+        bool InFrustum() const noexcept {
+            return valid && depth >= 0.f && nx >= 0.f && nx <= 1.f && ny >= 0.f && ny <= 1.f;
+        }
+    };
+    static thread_local std::unordered_map<RE::FormID, ScreenProj> g_proj;
+    static thread_local std::uint32_t g_projFrame{1};
+    constexpr float kAnchorOffsetZ = 70.0f;
+
+    bool ProjectWorld(RE::NiPoint3 world, float offsetZ, ScreenProj& out) {
+        out.valid = false;
+        if (!g_viewPort || !g_worldToCamMatrix) return false;
+        world.z += offsetZ;
+        RE::NiCamera::WorldPtToScreenPt3((float (*)[4])g_worldToCamMatrix, *g_viewPort, world, out.nx, out.ny,
+                                         out.depth, 1e-5f);
+        out.valid = true;
+        return true;
+    }
+
+    // Structure-of-arrays scratch for CullTracked, padded to a multiple of four lanes.
+    struct CullSoA {
+        std::vector<float> x, y, z;
+        std::vector<float> nx, ny, depth, w, dist2;
+        std::vector<std::uint8_t> anchored, pass;
+        std::vector<float> keptDist2;
+
+        void Resize(std::size_t n) {
+            const std::size_t padded = (n + 3) & ~std::size_t{3};
+            for (auto* v : {&x, &y, &z, &nx, &ny, &depth, &w, &dist2}) v->assign(padded, 0.f);
+            anchored.assign(padded, 0);
+            pass.assign(padded, 0);
+        }
+    };
+    static thread_local CullSoA g_cull;
+
+    // Same math as NiCamera::WorldPtToScreenPt3, four points per iteration. A lane passes when its w is not near
+    // zero, it lies inside the [0,1] viewport with non-negative depth, and it is within maxDist2 of the origin.
+    void ProjectCullSSE(const float (*m)[4], const RE::NiRect<float>& port, const RE::NiPoint3& origin, float maxDist2,
+                        CullSoA& s) {
+        const __m128 m00 = _mm_set1_ps(m[0][0]), m01 = _mm_set1_ps(m[0][1]), m02 = _mm_set1_ps(m[0][2]),
+                     m03 = _mm_set1_ps(m[0][3]);
+        const __m128 m10 = _mm_set1_ps(m[1][0]), m11 = _mm_set1_ps(m[1][1]), m12 = _mm_set1_ps(m[1][2]),
+                     m13 = _mm_set1_ps(m[1][3]);
+        const __m128 m20 = _mm_set1_ps(m[2][0]), m21 = _mm_set1_ps(m[2][1]), m22 = _mm_set1_ps(m[2][2]),
+                     m23 = _mm_set1_ps(m[2][3]);
+        const __m128 m30 = _mm_set1_ps(m[3][0]), m31 = _mm_set1_ps(m[3][1]), m32 = _mm_set1_ps(m[3][2]),
+                     m33 = _mm_set1_ps(m[3][3]);
+
+        const __m128 sx = _mm_set1_ps((port.right - port.left) * 0.5f);
+        const __m128 ox = _mm_set1_ps((port.right + port.left) * 0.5f);
+        const __m128 sy = _mm_set1_ps((port.top - port.bottom) * 0.5f);
+        const __m128 oy = _mm_set1_ps((port.top + port.bottom) * 0.5f);
+        const __m128 px = _mm_set1_ps(origin.x), py = _mm_set1_ps(origin.y), pz = _mm_set1_ps(origin.z);
+
+        const __m128 one = _mm_set1_ps(1.f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 tol = _mm_set1_ps(1e-5f);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 limit = _mm_set1_ps(maxDist2 > 0.f ? maxDist2 : std::numeric_limits<float>::infinity());
+
+        for (std::size_t i = 0; i < s.x.size(); i += 4) {
+            const __m128 x = _mm_loadu_ps(&s.x[i]);
+            const __m128 y = _mm_loadu_ps(&s.y[i]);
+            const __m128 z = _mm_loadu_ps(&s.z[i]);
+
+            const auto row = [&](__m128 a, __m128 b, __m128 c, __m128 d) {
+                return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, x), _mm_mul_ps(b, y)), _mm_add_ps(_mm_mul_ps(c, z), d));
+            };
+            const __m128 cx = row(m00, m01, m02, m03);
+            const __m128 cy = row(m10, m11, m12, m13);
+            const __m128 cz = row(m20, m21, m22, m23);
+            const __m128 cw = row(m30, m31, m32, m33);
+
+            const __m128 wOk = _mm_cmpgt_ps(_mm_and_ps(cw, absMask), tol);
+            const __m128 invW = _mm_div_ps(one, _mm_or_ps(_mm_andnot_ps(wOk, one), _mm_and_ps(wOk, cw)));
+
+            const __m128 nx = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(cx, invW), sx), ox);
+            const __m128 ny = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(cy, invW), sy), oy);
+            const __m128 depth = _mm_mul_ps(cz, invW);
+
+            const __m128 dx = _mm_sub_ps(x, px);
+            const __m128 dy = _mm_sub_ps(y, py);
+            const __m128 dz = _mm_sub_ps(z, pz);
+            const __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+            __m128 in = _mm_and_ps(wOk, _mm_cmpge_ps(depth, zero));
+            in = _mm_and_ps(in, _mm_and_ps(_mm_cmpge_ps(nx, zero), _mm_cmple_ps(nx, one)));
+            in = _mm_and_ps(in, _mm_and_ps(_mm_cmpge_ps(ny, zero), _mm_cmple_ps(ny, one)));
+            in = _mm_and_ps(in, _mm_cmple_ps(d2, limit));
+
+            _mm_storeu_ps(&s.nx[i], nx);
+            _mm_storeu_ps(&s.ny[i], ny);
+            _mm_storeu_ps(&s.depth[i], depth);
+            _mm_storeu_ps(&s.w[i], cw);
+            _mm_storeu_ps(&s.dist2[i], d2);
+
+            const int bits = _mm_movemask_ps(in);
+            for (int k = 0; k < 4; ++k) s.pass[i + k] = static_cast<std::uint8_t>((bits >> k) & 1);
+        }
+    }
+
+    const ScreenProj& ProjectAnchor(RE::Actor* a) {
+        auto& p = g_proj[a->GetFormID()];
+        if (p.frame == g_projFrame) return p;
+        p.frame = g_projFrame;
+        p.valid = false;
+        if (RE::NiPoint3 world{}; g_viewPort && g_worldToCamMatrix && Utils::GetAnchorPosFast(a, world)) {
+            ProjectWorld(world, kAnchorOffsetZ, p);
+        }
+        return p;
+    }
 
     constexpr std::size_t kHUD_TLS_CAP = 12;
     struct HUDTLS {
@@ -75,6 +197,10 @@ namespace {
                 hud.icon = nullptr;
             }
 
+            if (auto itW = st.widgets.find(pr.id); itW != st.widgets.end() && itW->second.widget) {
+                itW->second.widget->MarkDirty();
+            }
+
             auto [__itC, __insertedC] = st.combos.try_emplace(pr.id);
             auto& vec = __itC->second;
             std::erase_if(vec, [nowRt, nowH](const ActiveReactionHUD& c) {
@@ -174,6 +300,16 @@ namespace {
         }
         return h;
     }
+    static std::uint64_t hash_names(const std::vector<const char*>& names) {
+        auto h = fnv1a64_init();
+        for (const char* s : names) {
+            if (s) {
+                for (const auto* p = reinterpret_cast<const unsigned char*>(s); *p; ++p) h = fnv1a64_mix(h, *p);
+            }
+            h = fnv1a64_mix(h, 0);
+        }
+        return h;
+    }
 }
 
 void InjectHUD::ERFWidget::Initialize() {
@@ -191,6 +327,7 @@ void InjectHUD::ERFWidget::Initialize() {
 
     _arraysInit = false;
     EnsureArrays();
+    ForgetShownContent();
 }
 
 void InjectHUD::ERFWidget::FollowActorHead(RE::Actor* actor) {
@@ -201,18 +338,8 @@ void InjectHUD::ERFWidget::FollowActorHead(RE::Actor* actor) {
         return;
     }
 
-    if (!g_viewPort || !g_worldToCamMatrix) {
-        if (_lastVisible) {
-            RE::GFxValue vis;
-            vis.SetBoolean(false);
-            _object.SetMember("_visible", vis);
-            _lastVisible = false;
-        }
-        return;
-    }
-
-    RE::NiPoint3 world{};
-    if (!Utils::GetTargetPos(actor->CreateRefHandle(), world, true)) {
+    const ScreenProj& proj = ProjectAnchor(actor);
+    if (!proj.InFrustum()) {
         if (_lastVisible) {
             RE::GFxValue vis;
             vis.SetBoolean(false);
@@ -222,21 +349,9 @@ void InjectHUD::ERFWidget::FollowActorHead(RE::Actor* actor) {
         return;
     }
 
-    static constexpr float kWorldOffsetZ = 70.0f;
-    world.z += kWorldOffsetZ;
-
-    float nx = 0.f, ny = 0.f, depth = 0.f;
-    RE::NiCamera::WorldPtToScreenPt3((float (*)[4])g_worldToCamMatrix, *g_viewPort, world, nx, ny, depth, 1e-5f);
-
-    if (depth < 0.f || nx < 0.f || nx > 1.f || ny < 0.f || ny > 1.f) {
-        if (_lastVisible) {
-            RE::GFxValue vis;
-            vis.SetBoolean(false);
-            _object.SetMember("_visible", vis);
-            _lastVisible = false;
-        }
-        return;
-    }
+    float nx = proj.nx;
+    float ny = proj.ny;
+    const float depth = proj.depth;
 
     const RE::GRectF rect = _view->GetVisibleFrameRect();
     const float stageW = rect.right - rect.left;
@@ -327,106 +442,59 @@ void InjectHUD::ERFWidget::EnsureArrays() {
     _arraysInit = true;
 }
 
-bool InjectHUD::ERFWidget::FillArrayNames(RE::GFxValue& arr, const std::vector<const char*>& names,
-                                          std::uint64_t& lastHash) {
-    bool changed = false;
-
-    const std::uint32_t cur = arr.GetArraySize();
+void InjectHUD::ERFWidget::ForgetShownContent() {
+    _hComboRemain = _hComboTints = _hAccumVals = _hAccumCols = _hIconNames = 0;
+    _lastSpacing = std::numeric_limits<float>::quiet_NaN();
+}
 
-    if (const auto want = static_cast<std::uint32_t>(names.size()); cur != want) {
+void InjectHUD::ERFWidget::FillArrayNames(RE::GFxValue& arr, const std::vector<const char*>& names) {
+    const auto want = static_cast<std::uint32_t>(names.size());
+    if (arr.GetArraySize() != want) {
         _view->CreateArray(&arr);
         arr.SetArraySize(want);
-        for (std::uint32_t i = 0; i < want; ++i) {
-            RE::GFxValue v;
-            if (names[i] && names[i][0] != '\0')
-                v.SetString(names[i]);
-            else
-                v.SetNull();
-            arr.SetElement(i, v);
-        }
-        changed = true;
-    } else {
-        for (std::uint32_t i = 0; i < want; ++i) {
-            RE::GFxValue v;
-            if (names[i] && names[i][0] != '\0')
-                v.SetString(names[i]);
-            else
-                v.SetNull();
-            arr.SetElement(i, v);
-        }
-    }
-
-    std::uint64_t h = fnv1a64_init();
-    for (const char* s : names) {
-        if (!s) {
-            h = fnv1a64_mix(h, 0);
-            continue;
-        }
-        for (const auto* p = reinterpret_cast<const unsigned char*>(s); *p; ++p) {
-            h = fnv1a64_mix(h, *p);
-        }
-        h = fnv1a64_mix(h, 0);
     }
-    if (h != lastHash) {
-        lastHash = h;
-        changed = true;
+    for (std::uint32_t i = 0; i < want; ++i) {
+        RE::GFxValue v;
+        if (names[i] && names[i][0] != '\0')
+            v.SetString(names[i]);
+        else
+            v.SetNull();
+        arr.SetElement(i, v);
     }
-    return changed;
 }
 
-bool InjectHUD::ERFWidget::FillArrayDoubles(RE::GFxValue& arr, const std::vector<double>& src,
-                                            std::uint64_t& lastHash) {
-    bool changed = false;
-    const std::uint32_t cur = arr.GetArraySize();
-    if (const auto want = static_cast<std::uint32_t>(src.size()); cur != want) {
+void InjectHUD::ERFWidget::FillArrayDoubles(RE::GFxValue& arr, const std::vector<double>& src) {
+    if (const auto want = static_cast<std::uint32_t>(src.size()); arr.GetArraySize() != want) {
         _view->CreateArray(&arr);
         for (double d : src) {
             RE::GFxValue v;
             v.SetNumber(d);
             arr.PushBack(v);
         }
-        changed = true;
-    } else {
-        for (std::uint32_t i = 0; i < cur; ++i) {
-            RE::GFxValue v;
-            v.SetNumber(src[i]);
-            arr.SetElement(i, v);
-        }
+        return;
     }
-
-    if (const std::uint64_t h = hash_doubles_q(src); h != lastHash) {
-        changed = true;
-        lastHash = h;
+    for (std::uint32_t i = 0; i < src.size(); ++i) {
+        RE::GFxValue v;
+        v.SetNumber(src[i]);
+        arr.SetElement(i, v);
     }
-    return changed;
 }
 
-bool InjectHUD::ERFWidget::FillArrayU32AsNumber(RE::GFxValue& arr, const std::vector<std::uint32_t>& src,
-                                                std::uint64_t& lastHash) {
-    bool changed = false;
-    const std::uint32_t cur = arr.GetArraySize();
-
-    if (const auto want = static_cast<std::uint32_t>(src.size()); cur != want) {
+void InjectHUD::ERFWidget::FillArrayU32AsNumber(RE::GFxValue& arr, const std::vector<std::uint32_t>& src) {
+    if (const auto want = static_cast<std::uint32_t>(src.size()); arr.GetArraySize() != want) {
         _view->CreateArray(&arr);
         for (std::uint32_t u : src) {
             RE::GFxValue v;
             v.SetNumber(static_cast<double>(u));
             arr.PushBack(v);
         }
-        changed = true;
-    } else {
-        for (std::uint32_t i = 0; i < cur; ++i) {
-            RE::GFxValue v;
-            v.SetNumber(static_cast<double>(src[i]));
-            arr.SetElement(i, v);
-        }
+        return;
     }
-
-    if (const std::uint64_t h = hash_u32(src); h != lastHash) {
-        changed = true;
-        lastHash = h;
+    for (std::uint32_t i = 0; i < src.size(); ++i) {
+        RE::GFxValue v;
+        v.SetNumber(static_cast<double>(src[i]));
+        arr.SetElement(i, v);
     }
-    return changed;
 }
 
 void InjectHUD::ERFWidget::ClearAndHide(bool isSingle, bool isHorizontal, float spacingPx) {
@@ -466,6 +534,8 @@ void InjectHUD::ERFWidget::ClearAndHide(bool isSingle, bool isHorizontal, float
         _object.SetMember("_visible", vis);
         _lastVisible = false;
     }
+    MarkDirty();
+    ForgetShownContent();
     _lastIsSingle = isSingle;
     _lastIsHor = isHorizontal;
     _lastSpacing = spacingPx;
@@ -479,41 +549,62 @@ void InjectHUD::ERFWidget::SetAll(const std::vector<double>& comboRemain01,
                                   float spacingPx, std::uint32_t singlesBefore, std::uint32_t singlesAfter) {
     if (!_view) return;
 
-    EnsureArrays();
-
-    const bool chComboR = FillArrayDoubles(_arrComboRemain, comboRemain01, _hComboRemain);
-    const bool chComboT = FillArrayU32AsNumber(_arrComboTints, comboTintsRGB, _hComboTints);
-    const bool chAccumV = FillArrayDoubles(_arrAccumVals, accumValues, _hAccumVals);
-    const bool chAccumC = FillArrayU32AsNumber(_arrAccumCols, accumColorsRGB, _hAccumCols);
-    const bool chIcons = FillArrayNames(_arrIconNames, iconNames, _hIconNames);
+    // Hash first: unchanged arrays are neither rewritten element by element nor sent again.
+    const std::uint64_t hComboR = hash_doubles_q(comboRemain01);
+    const std::uint64_t hComboT = hash_u32(comboTintsRGB);
+    const std::uint64_t hAccumV = hash_doubles_q(accumValues);
+    const std::uint64_t hAccumC = hash_u32(accumColorsRGB);
+    const std::uint64_t hIcons = hash_names(iconNames);
 
-    _isSingle.SetBoolean(isSingle);
-    _isHorin.SetBoolean(isHorizontal);
-    _spacing.SetNumber(spacingPx);
-    _singlesBefore.SetNumber(static_cast<double>(singlesBefore));
-    _singlesAfter.SetNumber(static_cast<double>(singlesAfter));
-
-    _args[0] = _arrComboRemain;
-    _args[1] = _arrComboTints;
-    _args[2] = _arrAccumVals;
-    _args[3] = _arrAccumCols;
-    _args[4] = _arrIconNames;
-    _args[5] = _isSingle;
-    _args[6] = _isHorin;
-    _args[7] = _spacing;
-    _args[8] = _singlesBefore;
-    _args[9] = _singlesAfter;
+    const bool chComboR = hComboR != _hComboRemain;
+    const bool chComboT = hComboT != _hComboTints;
+    const bool chAccumV = hAccumV != _hAccumVals;
+    const bool chAccumC = hAccumC != _hAccumCols;
+    const bool chIcons = hIcons != _hIconNames;
 
     const bool flagsChanged = (_lastIsSingle != isSingle) || (_lastIsHor != isHorizontal) ||
                               !(std::isfinite(_lastSpacing) && std::abs(_lastSpacing - spacingPx) < 1e-6);
 
     const bool needInvoke = flagsChanged || chComboR || chComboT || chAccumV || chAccumC || chIcons;
 
-    RE::GFxValue ret;
     bool ok = true;
 
     if (needInvoke) {
+        EnsureArrays();
+
+        if (chComboR) FillArrayDoubles(_arrComboRemain, comboRemain01);
+        if (chComboT) FillArrayU32AsNumber(_arrComboTints, comboTintsRGB);
+        if (chAccumV) FillArrayDoubles(_arrAccumVals, accumValues);
+        if (chAccumC) FillArrayU32AsNumber(_arrAccumCols, accumColorsRGB);
+        if (chIcons) FillArrayNames(_arrIconNames, iconNames);
+
+        _isSingle.SetBoolean(isSingle);
+        _isHorin.SetBoolean(isHorizontal);
+        _spacing.SetNumber(spacingPx);
+        _singlesBefore.SetNumber(static_cast<double>(singlesBefore));
+        _singlesAfter.SetNumber(static_cast<double>(singlesAfter));
+
+        _args[0] = _arrComboRemain;
+        _args[1] = _arrComboTints;
+        _args[2] = _arrAccumVals;
+        _args[3] = _arrAccumCols;
+        _args[4] = _arrIconNames;
+        _args[5] = _isSingle;
+        _args[6] = _isHorin;
+        _args[7] = _spacing;
+        _args[8] = _singlesBefore;
+        _args[9] = _singlesAfter;
+
+        RE::GFxValue ret;
         ok = _object.Invoke("setAll", &ret, _args, 10);
+    }
+
+    if (needInvoke) {
+        _hComboRemain = hComboR;
+        _hComboTints = hComboT;
+        _hAccumVals = hAccumV;
+        _hAccumCols = hAccumC;
+        _hIconNames = hIcons;
         _lastIsSingle = isSingle;
         _lastIsHor = isHorizontal;
         _lastSpacing = spacingPx;
@@ -566,22 +657,15 @@ void InjectHUD::UpdateFor(RE::Actor* actor, double nowRt, float nowH) {
     acts.clear();
     GetActiveReactions(id, nowRt, nowH, acts);
 
-    auto bundleOpt = ElementalGauges::PickHudDecayed(id, nowRt, nowH);
-    const bool haveTotals =
-        bundleOpt && !bundleOpt->values.empty() &&
-        std::any_of(bundleOpt->values.begin(), bundleOpt->values.end(), [](std::uint32_t v) { return v > 0; });
-
-    if (const int needed = static_cast<int>(acts.size()) + (haveTotals ? 1 : 0); needed == 0) {
-        if (w._view && w._lastVisible) {
-            RE::GFxValue vis;
-            vis.SetBoolean(false);
-            w._object.SetMember("_visible", vis);
-            w._lastVisible = false;
-        }
+    // Running combos animate their remaining time, so only actors without them can skip the rebuild.
+    const auto version = ElementalGauges::VersionOf(id);
+    if (acts.empty() && w._shownCombos == 0 && version == w._shownVersion && w._shownEpoch == g_layoutEpoch) {
+        if (w._lastVisible) w.FollowActorHead(actor);
         return;
     }
-
-    const auto h = actor->GetHandle();
+    w._shownVersion = version;
+    w._shownEpoch = g_layoutEpoch;
+    w._shownCombos = acts.size();
 
     auto& comboRemain01 = g_hudTLS.comboRemain01;
     auto& comboTintsRGB = g_hudTLS.comboTintsRGB;
@@ -609,27 +693,26 @@ void InjectHUD::UpdateFor(RE::Actor* actor, double nowRt, float nowH) {
     accumValues.clear();
     accumColorsRGB.clear();
 
-    if (haveTotals) {
-        const auto& b = *bundleOpt;
-        if (accumValues.capacity() < b.values.size()) accumValues.reserve(b.values.size());
-        if (accumColorsRGB.capacity() < b.colors.size()) accumColorsRGB.reserve(b.colors.size());
-        for (auto v : b.values) accumValues.push_back(double(std::clamp<std::uint32_t>(v, 0, 100)));
-        accumColorsRGB.assign(b.colors.begin(), b.colors.end());
-        for (auto s : b.icons) IconNames.push_back(s);
+    ElementalGauges::HudGaugeOut gauges{accumValues, accumColorsRGB, IconNames};
+    const bool haveTotals = ElementalGauges::PickHudDecayed(id, nowRt, nowH, gauges);
+
+    if (const int needed = static_cast<int>(acts.size()) + (haveTotals ? 1 : 0); needed == 0) {
+        if (w._view && w._lastVisible) {
+            RE::GFxValue vis;
+            vis.SetBoolean(false);
+            w._object.SetMember("_visible", vis);
+            w._lastVisible = false;
+        }
+        return;
     }
 
     w.FollowActorHead(actor);
     const bool isSingle = g_snap.isSingle;
     const bool isHor = w._isPlayerWidget ? g_snap.playerHorizontal : g_snap.npcHorizontal;
     const float space = w._isPlayerWidget ? g_snap.playerSpacing : g_snap.npcSpacing;
-    std::uint32_t singlesBefore = 0;
-    std::uint32_t singlesAfter = 0;
-    if (haveTotals) {
-        singlesBefore = bundleOpt->singlesBefore;
-        singlesAfter = bundleOpt->singlesAfter;
-    }
     w.SetAll(comboRemain01, comboTintsRGB, accumValues, accumColorsRGB, IconNames, isSingle, isHor, space,
-             singlesBefore, singlesAfter);
+             gauges.singlesBefore, gauges.singlesAfter);
+    if (!w._lastVisible) w.MarkDirty();
 }
 
 void InjectHUD::BeginReaction(RE::Actor* a, ERF_ReactionHandle handle, float seconds) {
@@ -679,11 +762,13 @@ bool InjectHUD::RemoveFor(RE::FormID id) {
     }
     st.widgets.erase(it);
     st.combos.erase(id);
+    g_proj.erase(id);
     return true;
 }
 
 void InjectHUD::RemoveAllWidgets() {
     auto& st = InjectHUD::Globals();
+    g_proj.clear();
     if (!st.trueHUD) {
         st.widgets.clear();
         st.combos.clear();
@@ -707,6 +792,7 @@ void InjectHUD::OnTrueHUDClose() {
 
 void InjectHUD::OnUIFrameBegin(double nowRtS, float nowH) {
     const auto& cfg = ERF::GetConfig();
+    const HUDFrameSnapshot prev = g_snap;
     g_snap.hudEnabled = cfg.hudEnabled.load(std::memory_order_relaxed);
     g_snap.isSingle = cfg.isSingle.load(std::memory_order_relaxed);
     g_snap.playerHorizontal = cfg.playerHorizontal.load(std::memory_order_relaxed);
@@ -721,22 +807,74 @@ void InjectHUD::OnUIFrameBegin(double nowRtS, float nowH) {
     g_snap.npcScale = cfg.npcScale.load(std::memory_order_relaxed);
     g_snap.nowRtS = nowRtS;
     g_snap.nowH = nowH;
+    ++g_projFrame;
+    ElementalGauges::BeginHudFrame();
+    if (prev.isSingle != g_snap.isSingle || prev.playerHorizontal != g_snap.playerHorizontal ||
+        prev.npcHorizontal != g_snap.npcHorizontal || prev.playerSpacing != g_snap.playerSpacing ||
+        prev.npcSpacing != g_snap.npcSpacing) {
+        ++g_layoutEpoch;
+    }
     DrainComboQueueOnUI(nowRtS, nowH);
 }
 
+void InjectHUD::CullTracked(const std::vector<RE::Actor*>& actors, const RE::NiPoint3& origin, float maxDistance,
+                            std::size_t maxVisible, std::vector<std::uint32_t>& visible) {
+    visible.clear();
+    if (actors.empty() || !g_viewPort || !g_worldToCamMatrix) return;
+
+    auto& s = g_cull;
+    s.Resize(actors.size());
+
+    // Gathering stays scalar (node lookups); everything after it is one pass over flat arrays.
+    for (std::size_t i = 0; i < actors.size(); ++i) {
+        RE::NiPoint3 world{};
+        s.anchored[i] = actors[i] && Utils::GetAnchorPosFast(actors[i], world);
+        s.x[i] = world.x;
+        s.y[i] = world.y;
+        s.z[i] = world.z + kAnchorOffsetZ;
+    }
+
+    ProjectCullSSE((float (*)[4])g_worldToCamMatrix, *g_viewPort, origin, maxDistance * maxDistance, s);
+
+    for (std::size_t i = 0; i < actors.size(); ++i) {
+        if (!actors[i]) continue;
+        auto& p = g_proj[actors[i]->GetFormID()];
+        p.frame = g_projFrame;
+        p.valid = s.anchored[i] && std::fabs(s.w[i]) > 1e-5f;
+        p.nx = s.nx[i];
+        p.ny = s.ny[i];
+        p.depth = s.depth[i];
+        if (s.anchored[i] && s.pass[i]) visible.push_back(static_cast<std::uint32_t>(i));
+    }
+
+    if (maxVisible == 0 || visible.size() <= maxVisible) return;
+
+    // Keep the maxVisible nearest without reordering, so the scheduler's round-robin cursor stays meaningful.
+    auto& kept = s.keptDist2;
+    kept.clear();
+    for (auto i : visible) kept.push_back(s.dist2[i]);
+    std::nth_element(kept.begin(), kept.begin() + static_cast<std::ptrdiff_t>(maxVisible - 1), kept.end());
+    const float cutoff = kept[maxVisible - 1];
+
+    std::size_t below = 0;
+    for (auto i : visible) below += s.dist2[i] < cutoff ? 1 : 0;
+    std::size_t ties = maxVisible - below;
+    std::erase_if(visible, [&](std::uint32_t i) {
+        if (s.dist2[i] < cutoff) return false;
+        if (s.dist2[i] == cutoff && ties != 0) {
+            --ties;
+            return false;
+        }
+        return true;
+    });
+}
+
 bool InjectHUD::IsOnScreen(RE::Actor* actor, float worldOffsetZ) noexcept {
     if (!actor || !g_viewPort || !g_worldToCamMatrix) return false;
 
-    RE::NiPoint3 world{};
-    if (!Utils::GetTargetPos(actor->CreateRefHandle(), world, /*bGetTorsoPos=*/true)) return false;
-
-    world.z += worldOffsetZ;
+    if (worldOffsetZ == kAnchorOffsetZ) return ProjectAnchor(actor).InFrustum();
 
-    float nx = 0.f;
-    float ny = 0.f;
-    float depth = 0.f;
-    RE::NiCamera::WorldPtToScreenPt3((float (*)[4])g_worldToCamMatrix, *g_viewPort, world, nx, ny, depth, 1e-5f);
-    if (depth < 0.f) return false;
-
-    return (nx >= 0.f && nx <= 1.f && ny >= 0.f && ny <= 1.f);
-}
\ No newline at end of file
+    RE::NiPoint3 world{};
+    ScreenProj p{};
+    return Utils::GetAnchorPosFast(actor, world) && ProjectWorld(world, worldOffsetZ, p) && p.InFrustum();
+}
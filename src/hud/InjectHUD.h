@@ -102,6 +102,15 @@ namespace InjectHUD {
         bool _lastVisible{false};
         float _lastScale{std::numeric_limits<float>::quiet_NaN()};
 
+        // What the last full SetAll showed; an actor whose gauge version, combo count and layout epoch all match
+        // only needs its position followed.
+        static constexpr std::uint64_t kNoVersion = ~std::uint64_t{0};
+        std::uint64_t _shownVersion{kNoVersion};
+        std::uint32_t _shownEpoch{0};
+        std::size_t _shownCombos{0};
+
+        void MarkDirty() { _shownVersion = kNoVersion; }
+
         void Initialize() override;
         void Update(float) override {
             // nothing here
@@ -147,9 +156,10 @@ namespace InjectHUD {
         RE::GFxValue _args[10];
 
         void EnsureArrays();
-        bool FillArrayNames(RE::GFxValue& arr, const std::vector<const char*>& names, std::uint64_t& lastHash);
-        bool FillArrayDoubles(RE::GFxValue& arr, const std::vector<double>& src, std::uint64_t& lastHash);
-        bool FillArrayU32AsNumber(RE::GFxValue& arr, const std::vector<std::uint32_t>& src, std::uint64_t& lastHash);
+        void ForgetShownContent();
+        void FillArrayNames(RE::GFxValue& arr, const std::vector<const char*>& names);
+        void FillArrayDoubles(RE::GFxValue& arr, const std::vector<double>& src);
+        void FillArrayU32AsNumber(RE::GFxValue& arr, const std::vector<std::uint32_t>& src);
     };
 
     void AddFor(RE::Actor* actor);
@@ -165,6 +175,13 @@ namespace InjectHUD {
 
     bool IsOnScreen(RE::Actor* a, float worldOffsetZ = 70.0f) noexcept;
 
+    // Projects the anchors of all `actors` in one SIMD pass and stores the results in this frame's projection cache,
+    // so IsOnScreen and FollowActorHead do not project them again. `visible` receives the indices, in input order,
+    // of the actors inside the view and within maxDistance of `origin`, capped to the maxVisible nearest
+    // (0 disables either limit).
+    void CullTracked(const std::vector<RE::Actor*>& actors, const RE::NiPoint3& origin, float maxDistance,
+                     std::size_t maxVisible, std::vector<std::uint32_t>& visible);
+
     inline double NowRtS() {
         using clock = std::chrono::steady_clock;
         static const auto t0 = clock::now();
@@ -13,6 +13,8 @@
 #include "elemental_reactions/ElementalGauges.h"
 #include "elemental_reactions/ElementalGaugesHook.h"
 #include "elemental_reactions/ElementalStates.h"
+#include "elemental_reactions/RegistrySchema.h"
+#include "hud/HUDTick.h"
 #include "hud/InjectHUD.h"
 #include "hud/TrueHUDMenuWatcher.h"
 #include "ui/ERF_UI.h"
@@ -50,6 +52,7 @@ namespace {
                 ERF::API::OpenRegistrationWindowAndScheduleFreeze();
                 ElementalGaugesHook::InitCarrierRefs();
                 ElementalGaugesHook::Install();
+                HUD::InstallFrameHook();
                 ElementalGaugesHook::RegisterAEEventSink();
 
                 auto& st = InjectHUD::Globals();
@@ -102,10 +105,7 @@ namespace {
 }
 
 extern "C" DLLEXPORT void* SKSEAPI RequestPluginAPI(std::uint32_t requestedVersion) {
-    if (requestedVersion == ERF_API_VERSION) {
-        return static_cast<void*>(ERF::API::Get());
-    }
-    return nullptr;
+    return static_cast<void*>(ERF::API::Get(requestedVersion));
 }
 
 extern "C" DLLEXPORT bool SKSEAPI SKSEPlugin_Load(const SKSE::LoadInterface* skse) {
@@ -114,6 +114,7 @@ extern "C" DLLEXPORT bool SKSEAPI SKSEPlugin_Load(const SKSE::LoadInterface* sks
 
     Ser::Install(FOURCC('E', 'L', 'R', 'E'));
 
+    RegistrySchema::RegisterStore();
     ElementalStates::RegisterStore();
     ElementalGauges::RegisterStore();
 
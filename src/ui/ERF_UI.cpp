@@ -2,6 +2,9 @@
 
 #include <fstream>
 
+#include "../elemental_reactions/ElementalGauges.h"
+#include "../elemental_reactions/GaugeTrace.h"
+#include "../hud/HUDTick.h"
 #include "../overrides/Overrides.h"
 
 void __stdcall ERF_UI::DrawGeneral() {
@@ -39,6 +42,20 @@ void __stdcall ERF_UI::DrawGeneral() {
             "Mixed: Combines different elements into the same accumulator.");
     }
 
+    if (bool trace = ERF::GetConfig().traceGauges.load(std::memory_order_relaxed);
+        ImGui::Checkbox("Record gauge trace", &trace)) {
+        ERF::GetConfig().traceGauges.store(trace, std::memory_order_relaxed);
+        ERF::GetConfig().Save();
+        if (trace && ERF::API::Caps().ready) {
+            GaugeTrace::Start();
+        } else if (!trace) {
+            GaugeTrace::Stop();
+        }
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Writes every gauge hit and reaction to SKSE/ERF/ERFGauges.trace for offline replay.");
+    }
+
     ImGui::Separator();
 
     float pm = ERF::GetConfig().playerMult.load(std::memory_order_relaxed);
@@ -176,6 +193,59 @@ void __stdcall ERF_UI::DrawHUD() {
     if (ImGui::IsItemHovered()) {
         ImGui::SetTooltip("Distance between the npc's gauges in pixels.");
     }
+
+    ImGui::Spacing();
+    ImGui::Separator();
+
+    ImGui::TextUnformatted("Scheduler");
+    ImGui::Separator();
+
+    int budget = ERF::GetConfig().hudFrameBudgetUs.load(std::memory_order_relaxed);
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::InputInt("Frame budget (us)", &budget, 100, 500)) {
+        if (budget < 0) budget = 0;
+        ERF::GetConfig().hudFrameBudgetUs.store(budget, std::memory_order_relaxed);
+        ERF::GetConfig().Save();
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip(
+            "Time the HUD may spend per frame on NPC gauges. The player and the current target are always updated;\n"
+            "other widgets past the budget wait for the next frame. 0 = no limit.");
+    }
+
+    float maxDist = ERF::GetConfig().hudMaxDistance.load(std::memory_order_relaxed);
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::InputFloat("Max distance", &maxDist, 500.0f, 2000.0f, "%.0f")) {
+        if (maxDist < 0.0f) maxDist = 0.0f;
+        ERF::GetConfig().hudMaxDistance.store(maxDist, std::memory_order_relaxed);
+        ERF::GetConfig().Save();
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("NPC gauges farther than this from the player (in game units) are hidden. 0 = no limit.");
+    }
+
+    int maxVisible = ERF::GetConfig().hudMaxVisible.load(std::memory_order_relaxed);
+    ImGui::SetNextItemWidth(200.0f);
+    if (ImGui::InputInt("Max visible", &maxVisible, 1, 10)) {
+        if (maxVisible < 0) maxVisible = 0;
+        ERF::GetConfig().hudMaxVisible.store(maxVisible, std::memory_order_relaxed);
+        ERF::GetConfig().Save();
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip(
+            "Only the closest NPC gauges on screen are shown. The player and the current target do not count.\n"
+            "0 = no limit.");
+    }
+
+    const auto cost = HUD::GetFrameCost();
+    ImGui::Text("Last frame: %.0f us (avg %.0f, peak %.0f)", cost.lastUs, cost.avgUs, cost.peakUs);
+    ImGui::Text("Widgets updated: %u, deferred: %u, culled: %u", cost.updated, cost.deferred, cost.culled);
+
+    const auto icons = ElementalGauges::GetIconCacheStats();
+    const auto lookups = icons.hits + icons.misses;
+    ImGui::Text("Icon cache: %.1f%% hits (%llu lookups)",
+                lookups ? 100.0 * static_cast<double>(icons.hits) / static_cast<double>(lookups) : 0.0,
+                static_cast<unsigned long long>(lookups));
 }
 
 struct _SpellRow {